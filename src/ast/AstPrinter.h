@@ -3,34 +3,42 @@
 #include <iostream>
 #include <string>
 
-class AstPrinter : public StmtVisitor {
+class AstPrinter {
 public:
-    void visitImportStmt(ImportStmt& stmt) {
+    void visit(const ImportStmt& stmt) {
         std::cout << "[ImportStmt]\n";
-        for (auto& entry : stmt.entries) {
+        for (const auto& entry : stmt.entries) {
             std::cout << "  " << entry.name << " as " << entry.alias << "\n";
         }
     }
 
-    void visitPlayStmt(PlayStmt& stmt) override {
+    void visit(const PlayStmt& stmt) {
         std::cout << "[PlayStmt] alias=" << stmt.alias << "\n";
     }
 
-    void visitSetStmt(SetStmt& stmt) override {
+    void visit(const SetStmt& stmt) {
         std::cout << "[SetStmt] alias=" << stmt.alias << "\n";
-        for (auto& p : stmt.params) {
-            std::cout << "  " << p.name << " = " << p.value << "\n";
+        for (const auto& p : stmt.params) {
+            std::cout << "  " << p.name << " = " << p.value.text << "\n";
         }
     }
 
-    void visitCpmStmt(CpmStmt& stmt) override {
-        std::cout << "[CpmStmt] value=" << stmt.value << "\n";
+    void visit(const CpmStmt& stmt) {
+        std::cout << "[CpmStmt] value=" << stmt.value.toDouble();
+        if (stmt.change) {
+            std::cout << " at=" << stmt.atBeat.toDouble();
+            if (stmt.rampBeats.num > 0) {
+                std::cout << " ramp=" << stmt.rampBeats.toDouble()
+                    << (stmt.shape == RampShape::Exponential ? " exp" : " linear");
+            }
+        }
+        std::cout << "\n";
     }
 
-    void visitLoopStmt(LoopStmt& stmt) override {
+    void visit(const LoopStmt& stmt) {
         std::cout << "[LoopStmt]" << "\n";
-        for (auto& p : stmt.params) {
-            std::cout << " " << p.name << " = " << p.value << "\n";
+        for (const auto& p : stmt.params) {
+            std::cout << " " << p.name << " = " << p.value.text << "\n";
         }
     }
 };
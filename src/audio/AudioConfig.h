@@ -0,0 +1,13 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include "audio/Resampler.h"
+#include "audio/VoicePool.h"
+
+struct AudioConfig {
+    ma_uint32 sampleRate = 48000;
+    // The mixer renders the device buffer in chunks of at most this size.
+    ma_uint32 blockFrames = 128;
+    // Used for every voice whose pitch is not exactly 1.
+    Interpolation interpolation = Interpolation::Sinc;
+    VoicePoolConfig voices;
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include "audio/SampleBank.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// What the control side may ask of the audio thread.
+struct AudioCommand {
+    enum class Type : std::uint8_t {
+        Trigger,       // start `pcm` at `frame` with `gain` and `pitch`
+        SetMasterGain, // `gain` becomes the output gain
+    };
+
+    Type type = Type::Trigger;
+    SampleHandle sample = InvalidSample;
+    float gain = 1.0f;
+    float pitch = 1.0f;
+    ma_uint64 frame = 0;
+    const float* pcm = nullptr;
+    ma_uint64 frameCount = 0;
+};
+
+static_assert(sizeof(AudioCommand) <= 40, "audio commands are copied by value through the queue");
+
+// Wait-free single-producer/single-consumer ring. push() is only called from
+// the control thread and pop() only from the audio thread; neither ever
+// blocks or allocates. Each side caches the other's index so the shared
+// cache line is only touched when the cached view runs out.
+template <typename T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of two.
+    void init(size_t minCapacity) {
+        capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+        mask = capacity - 1;
+        slots = std::make_unique<T[]>(capacity);
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        cachedHead = 0;
+        cachedTail = 0;
+    }
+
+    bool push(const T& value) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - cachedTail >= capacity) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h - cachedTail >= capacity) return false;
+        }
+        slots[h & mask] = value;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t == cachedHead) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t == cachedHead) return false;
+        }
+        out = slots[t & mask];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::unique_ptr<T[]> slots;
+    size_t capacity = 0;
+    size_t mask = 0;
+
+    // Producer side.
+    alignas(64) std::atomic<size_t> head{ 0 };
+    size_t cachedTail = 0;
+
+    // Consumer side.
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    size_t cachedHead = 0;
+};
@@ -0,0 +1,141 @@
+#include "audio/MixKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WAVES_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WAVES_TARGET(isa) __attribute__((target(isa)))
+#else
+#define WAVES_TARGET(isa)
+#endif
+
+static void mixScalar(float* dst, const float* src, size_t sampleCount, float gain) {
+    for (size_t i = 0; i < sampleCount; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+#ifdef WAVES_X86
+
+WAVES_TARGET("sse2")
+static void mixSse2(float* dst, const float* src, size_t sampleCount, float gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= sampleCount; i += 8) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g));
+        __m128 b = _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(_mm_loadu_ps(src + i + 4), g));
+        _mm_storeu_ps(dst + i, a);
+        _mm_storeu_ps(dst + i + 4, b);
+    }
+    for (; i < sampleCount; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+WAVES_TARGET("avx2,fma")
+static void mixAvx2(float* dst, const float* src, size_t sampleCount, float gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= sampleCount; i += 16) {
+        __m256 a = _mm256_fmadd_ps(_mm256_loadu_ps(src + i), g, _mm256_loadu_ps(dst + i));
+        __m256 b = _mm256_fmadd_ps(_mm256_loadu_ps(src + i + 8), g, _mm256_loadu_ps(dst + i + 8));
+        _mm256_storeu_ps(dst + i, a);
+        _mm256_storeu_ps(dst + i + 8, b);
+    }
+    for (; i < sampleCount; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+WAVES_TARGET("avx512f")
+static void mixAvx512(float* dst, const float* src, size_t sampleCount, float gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 16 <= sampleCount; i += 16) {
+        _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(_mm512_loadu_ps(src + i), g, _mm512_loadu_ps(dst + i)));
+    }
+    if (i < sampleCount) {
+        const __mmask16 mask = static_cast<__mmask16>((1u << (sampleCount - i)) - 1u);
+        const __m512 d = _mm512_maskz_loadu_ps(mask, dst + i);
+        const __m512 s = _mm512_maskz_loadu_ps(mask, src + i);
+        _mm512_mask_storeu_ps(dst + i, mask, _mm512_fmadd_ps(s, g, d));
+    }
+}
+
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+    bool avx512f = false;
+};
+
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int out[4];
+    __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(out[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static unsigned long long readXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+// Instruction support alone is not enough: the OS must also save the wider
+// register state on context switch, which XCR0 reports.
+static CpuFeatures detectCpuFeatures() {
+    CpuFeatures features;
+    unsigned regs[4] = {};
+
+    cpuid(0, 0, regs);
+    const unsigned maxLeaf = regs[0];
+
+    cpuid(1, 0, regs);
+    features.sse2 = (regs[3] >> 26) & 1;
+    const bool osxsave = (regs[2] >> 27) & 1;
+    const bool fma = (regs[2] >> 12) & 1;
+    if (!osxsave || maxLeaf < 7) return features;
+
+    const unsigned long long xcr0 = readXcr0();
+    const bool osAvx = (xcr0 & 0x6) == 0x6;
+    const bool osAvx512 = (xcr0 & 0xE6) == 0xE6;
+
+    cpuid(7, 0, regs);
+    features.avx2 = osAvx && fma && ((regs[1] >> 5) & 1);
+    features.avx512f = osAvx512 && ((regs[1] >> 16) & 1);
+    return features;
+}
+
+#endif
+
+const std::vector<MixKernelInfo>& supportedMixKernels() {
+    static const std::vector<MixKernelInfo> kernels = [] {
+        std::vector<MixKernelInfo> list{ { "scalar", mixScalar } };
+#ifdef WAVES_X86
+        const CpuFeatures cpu = detectCpuFeatures();
+        if (cpu.sse2) list.push_back({ "sse2", mixSse2 });
+        if (cpu.avx2) list.push_back({ "avx2", mixAvx2 });
+        if (cpu.avx512f) list.push_back({ "avx512", mixAvx512 });
+#endif
+        return list;
+    }();
+    return kernels;
+}
+
+const MixKernelInfo& selectedMixKernel() {
+    return supportedMixKernels().back();
+}
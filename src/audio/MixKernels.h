@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// dst[i] += src[i] * gain over `sampleCount` interleaved samples.
+using MixKernel = void (*)(float* dst, const float* src, size_t sampleCount, float gain);
+
+struct MixKernelInfo {
+    const char* name;
+    MixKernel kernel;
+};
+
+// Every kernel this CPU can run, slowest first. The scalar kernel is always
+// present.
+const std::vector<MixKernelInfo>& supportedMixKernels();
+
+// The fastest supported kernel, picked once by CPUID on first use.
+const MixKernelInfo& selectedMixKernel();
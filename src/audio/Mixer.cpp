@@ -0,0 +1,122 @@
+#include "audio/Mixer.h"
+
+#include <algorithm>
+#include <cstring>
+
+void Mixer::init(const AudioConfig& config) {
+    blockFrames = std::clamp<ma_uint32>(config.blockFrames, 16, maxBlockFrames);
+    mix = selectedMixKernel().kernel;
+    interpolation = config.interpolation;
+    initResampler();
+    scratch = std::make_unique<float[]>(maxBlockFrames * channels);
+    voices.init(config.voices);
+    commands.init(commandCapacity);
+    pending = std::make_unique<AudioCommand[]>(pendingCapacity);
+    pendingCount = 0;
+    masterGain = 1.0f;
+    clock.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    outstanding.store(0, std::memory_order_relaxed);
+    onsets.reset();
+}
+
+bool Mixer::post(const AudioCommand& command) {
+    const bool trigger = command.type == AudioCommand::Type::Trigger;
+    if (trigger) {
+        if (outstanding.load(std::memory_order_acquire) >= pendingCapacity) return false;
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (commands.push(command)) return true;
+    if (trigger) outstanding.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Mixer::drainCommands() {
+    AudioCommand command;
+    while (commands.pop(command)) {
+        switch (command.type) {
+        case AudioCommand::Type::Trigger:
+            if (pendingCount == pendingCapacity) {
+                // post() keeps this from happening; counted in case it does.
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                outstanding.fetch_sub(1, std::memory_order_release);
+                break;
+            }
+            pending[pendingCount++] = command;
+            break;
+        case AudioCommand::Type::SetMasterGain:
+            masterGain = command.gain;
+            break;
+        }
+    }
+}
+
+void Mixer::startDueVoices(ma_uint64 blockStart, ma_uint64 blockEnd) {
+    size_t i = 0;
+    while (i < pendingCount) {
+        const AudioCommand& trigger = pending[i];
+        if (trigger.frame >= blockEnd) {
+            ++i;
+            continue;
+        }
+
+        Voice* voice = voices.allocate(trigger.sample);
+        voice->pcm = trigger.pcm;
+        voice->frameCount = trigger.frameCount;
+        voice->startFrame = trigger.frame;
+        voice->gain = trigger.gain;
+        voice->step = pitchToStep(trigger.pitch);
+        voice->sincBand = sincBandForStep(voice->step);
+        onsets.record(trigger.frame, (std::max)(trigger.frame, blockStart));
+
+        pending[i] = pending[--pendingCount];
+        outstanding.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void Mixer::renderBlock(float* out, ma_uint64 blockStart, ma_uint32 frameCount) {
+    std::memset(out, 0, sizeof(float) * frameCount * channels);
+
+    drainCommands();
+    const ma_uint64 blockEnd = blockStart + frameCount;
+    startDueVoices(blockStart, blockEnd);
+
+    for (Voice& voice : voices) {
+        if (!voice.active) continue;
+
+        // A voice whose start frame already passed starts at the block head.
+        const ma_uint32 offset = voice.startFrame > blockStart
+            ? static_cast<ma_uint32>(voice.startFrame - blockStart)
+            : 0;
+        const ma_uint32 wanted = frameCount - offset;
+        float* dst = out + offset * channels;
+
+        if (voice.step == phaseOne && (voice.phase & (phaseOne - 1)) == 0) {
+            // Unity pitch: mix straight from the bank.
+            const ma_uint64 position = voice.phase >> phaseFractionBits;
+            const ma_uint32 count = static_cast<ma_uint32>((std::min<ma_uint64>)(wanted, voice.frameCount - position));
+            mix(dst, voice.pcm + position * channels, count * channels, voice.gain * masterGain);
+            voice.phase += static_cast<ma_uint64>(count) << phaseFractionBits;
+            if (count < wanted) voice.active = false;
+            continue;
+        }
+
+        const ma_uint32 count = resample(interpolation, voice.sincBand, voice.pcm, voice.frameCount,
+            voice.phase, voice.step, scratch.get(), wanted);
+        mix(dst, scratch.get(), count * channels, voice.gain * masterGain);
+        if (count < wanted) voice.active = false;
+    }
+}
+
+void Mixer::render(float* out, ma_uint32 frameCount) {
+    ma_uint64 now = clock.load(std::memory_order_relaxed);
+    while (frameCount > 0) {
+        const ma_uint32 block = (std::min)(frameCount, blockFrames);
+        renderBlock(out, now, block);
+        out += block * channels;
+        now += block;
+        frameCount -= block;
+    }
+
+    clock.store(now, std::memory_order_release);
+}
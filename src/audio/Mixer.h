@@ -0,0 +1,73 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include "audio/AudioConfig.h"
+#include "audio/CommandQueue.h"
+#include "audio/MixKernels.h"
+#include "audio/OnsetHistogram.h"
+#include "audio/SampleBank.h"
+#include "audio/VoicePool.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// WavesLang's real-time mixer. render() is called from the device callback
+// and never allocates, locks or does stream I/O. Commands arrive through a
+// wait-free SPSC queue that is drained at the start of every block;
+// triggers then wait in a fixed pending list until their start frame falls
+// inside the block being rendered, only then taking a voice from the fixed
+// pool. Output is produced in blocks of `blockFrames`.
+class Mixer {
+public:
+    static constexpr ma_uint32 channels = SampleBank::channels;
+    static constexpr ma_uint32 maxBlockFrames = 1024;
+    static constexpr size_t commandCapacity = 1024;
+    static constexpr size_t pendingCapacity = 1024;
+
+    void init(const AudioConfig& config);
+
+    // Control thread only. Returns false if the queue is full or, for a
+    // trigger, if `pendingCapacity` triggers are already waiting to start;
+    // the caller keeps the command and retries once voices have started.
+    bool post(const AudioCommand& command);
+
+    // Audio thread. Fills `frameCount` interleaved frames.
+    void render(float* out, ma_uint32 frameCount);
+
+    // Frames rendered so far; this is the engine clock.
+    ma_uint64 framesRendered() const { return clock.load(std::memory_order_acquire); }
+
+    // Only meaningful once rendering has stopped.
+    ma_uint64 stolenCount() const { return voices.stolenCount(); }
+    ma_uint64 droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Safe to call from any thread while rendering.
+    OnsetStats onsetStats() const { return onsets.snapshot(); }
+
+private:
+    ma_uint32 blockFrames = 128;
+    MixKernel mix = nullptr;
+    Interpolation interpolation = Interpolation::Sinc;
+    VoicePool voices;
+
+    // Resampled output of one pitched voice for the current block.
+    std::unique_ptr<float[]> scratch;
+
+    SpscQueue<AudioCommand> commands;
+
+    // Triggers whose start frame has not been reached yet.
+    std::unique_ptr<AudioCommand[]> pending;
+    size_t pendingCount = 0;
+
+    float masterGain = 1.0f;
+
+    std::atomic<ma_uint64> clock{ 0 };
+    std::atomic<ma_uint64> dropped{ 0 };
+    // Triggers posted but not started yet, so post() can refuse before the
+    // pending list would overflow on the audio thread.
+    std::atomic<size_t> outstanding{ 0 };
+    OnsetHistogram onsets;
+
+    void drainCommands();
+    void startDueVoices(ma_uint64 blockStart, ma_uint64 blockEnd);
+    void renderBlock(float* out, ma_uint64 blockStart, ma_uint32 frameCount);
+};
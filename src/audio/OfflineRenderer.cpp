@@ -0,0 +1,94 @@
+#include "audio/OfflineRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// The encoder writes through our own FILE so that I/O errors are seen:
+// stdio keeps accepting data into its buffer after a failed flush, so the
+// error flag has to be checked on every write and again when closing.
+static ma_result writeFile(ma_encoder* encoder, const void* data, size_t bytes, size_t* written) {
+    std::FILE* file = static_cast<std::FILE*>(encoder->pUserData);
+    *written = std::fwrite(data, 1, bytes, file);
+    if (std::ferror(file)) {
+        *written = 0;
+        return MA_IO_ERROR;
+    }
+    return *written == bytes ? MA_SUCCESS : MA_IO_ERROR;
+}
+
+static ma_result seekFile(ma_encoder* encoder, ma_int64 offset, ma_seek_origin origin) {
+    std::FILE* file = static_cast<std::FILE*>(encoder->pUserData);
+    const int whence = origin == ma_seek_origin_start ? SEEK_SET
+        : origin == ma_seek_origin_end ? SEEK_END
+        : SEEK_CUR;
+#ifdef _WIN32
+    const int result = _fseeki64(file, offset, whence);
+#else
+    const int result = fseeko(file, static_cast<off_t>(offset), whence);
+#endif
+    return result == 0 ? MA_SUCCESS : MA_IO_ERROR;
+}
+
+bool OfflineRenderer::open(const std::string& outputPath, ma_uint32 rate, double seconds) {
+    file = std::fopen(outputPath.c_str(), "wb");
+    ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, Mixer::channels, rate);
+    if (!file || ma_encoder_init(writeFile, seekFile, file, &config, &encoder) != MA_SUCCESS) {
+        if (file) std::fclose(file);
+        file = nullptr;
+        std::cerr << "[RenderError] Cannot open " << outputPath << " for writing.\n";
+        return false;
+    }
+
+    isOpen = true;
+    failed = false;
+    path = outputPath;
+    sampleRate = rate;
+    endFrame = static_cast<ma_uint64>(std::llround(seconds * rate));
+    chunk = std::make_unique<float[]>(chunkFrames * Mixer::channels);
+    startTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool OfflineRenderer::renderTo(Mixer& mixer, ma_uint64 frame) {
+    if (!isOpen || failed) return false;
+
+    const ma_uint64 target = (std::min)(frame, endFrame);
+    ma_uint64 now = mixer.framesRendered();
+    while (now < target) {
+        const ma_uint32 count = static_cast<ma_uint32>((std::min<ma_uint64>)(chunkFrames, target - now));
+        mixer.render(chunk.get(), count);
+        ma_uint64 written = 0;
+        if (ma_encoder_write_pcm_frames(&encoder, chunk.get(), count, &written) != MA_SUCCESS || written != count) {
+            std::cerr << "[RenderError] Failed writing " << path << ".\n";
+            failed = true;
+            return false;
+        }
+        now += count;
+    }
+    return now < endFrame;
+}
+
+bool OfflineRenderer::close(Mixer& mixer) {
+    if (!isOpen) return false;
+
+    renderTo(mixer, endFrame);
+    // Uninit rewrites the header sizes, so the file is only checked after.
+    ma_encoder_uninit(&encoder);
+    const bool clean = !std::ferror(file);
+    const bool flushed = std::fclose(file) == 0 && clean;
+    file = nullptr;
+    isOpen = false;
+
+    if (!flushed && !failed) {
+        std::cerr << "[RenderError] Failed writing " << path << ".\n";
+        failed = true;
+    }
+    if (failed) return false;
+
+    const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - startTime;
+    const double rendered = static_cast<double>(endFrame) / sampleRate;
+    std::cout << "[Render] Wrote " << rendered << " s to " << path << " in " << wall.count()
+        << " s (" << (wall.count() > 0.0 ? rendered / wall.count() : 0.0) << "x realtime).\n";
+    return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include "audio/Mixer.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Drives a Mixer from a virtual clock instead of a device and writes the
+// result to a WAV file. The clock only moves when renderTo() is called, so a
+// program renders as fast as the CPU allows.
+class OfflineRenderer {
+public:
+    bool open(const std::string& path, ma_uint32 sampleRate, double seconds);
+
+    // Renders until the mixer clock reaches `frame` or the end of the render,
+    // whichever comes first. Returns false once the end has been reached or
+    // the file could not be written.
+    bool renderTo(Mixer& mixer, ma_uint64 frame);
+
+    // Renders whatever is left, finalizes the file and reports the speed.
+    // Returns false if any part of the render failed to write.
+    bool close(Mixer& mixer);
+
+private:
+    static constexpr ma_uint32 chunkFrames = 4096;
+
+    ma_encoder encoder;
+    std::FILE* file = nullptr;
+    bool isOpen = false;
+    bool failed = false;
+    std::string path;
+    ma_uint32 sampleRate = 0;
+    ma_uint64 endFrame = 0;
+    std::unique_ptr<float[]> chunk;
+    std::chrono::steady_clock::time_point startTime;
+};
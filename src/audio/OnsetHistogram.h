@@ -0,0 +1,93 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+// Summary of how late voices started relative to their scheduled frame.
+// Percentiles are exact below OnsetHistogram::exactFrames and otherwise the
+// top of their power-of-two bucket, capped at the maximum.
+struct OnsetStats {
+    ma_uint64 count = 0;
+    ma_uint64 late = 0;
+    ma_uint64 p50 = 0;
+    ma_uint64 p99 = 0;
+    ma_uint64 max = 0;
+};
+
+// Onset jitter: for every triggered voice, the frame it actually started
+// rendering on minus the frame it was scheduled for. Only the audio thread
+// records; any thread may take a snapshot at any time. Every counter is a
+// relaxed atomic with a single writer, so record() is a few uncontended
+// stores and never blocks.
+class OnsetHistogram {
+public:
+    // Lateness below this is counted frame by frame, above it per power
+    // of two.
+    static constexpr ma_uint32 exactFrames = 128;
+    static constexpr ma_uint32 bucketCount = exactFrames + 64 - std::bit_width(exactFrames - 1);
+
+    void reset() {
+        for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        late.store(0, std::memory_order_relaxed);
+        maxLate.store(0, std::memory_order_relaxed);
+    }
+
+    // Audio thread only. `actual` is never before `scheduled`: a trigger
+    // that arrives after its frame starts at the head of the next block.
+    void record(ma_uint64 scheduled, ma_uint64 actual) {
+        const ma_uint64 frames = actual - scheduled;
+        bump(buckets[bucketOf(frames)]);
+        bump(total);
+        if (frames == 0) return;
+        bump(late);
+        if (frames > maxLate.load(std::memory_order_relaxed)) maxLate.store(frames, std::memory_order_relaxed);
+    }
+
+    OnsetStats snapshot() const {
+        OnsetStats stats;
+        stats.count = total.load(std::memory_order_relaxed);
+        stats.late = late.load(std::memory_order_relaxed);
+        stats.max = maxLate.load(std::memory_order_relaxed);
+        stats.p50 = percentile(stats.count, 50, stats.max);
+        stats.p99 = percentile(stats.count, 99, stats.max);
+        return stats;
+    }
+
+private:
+    std::atomic<ma_uint64> buckets[bucketCount] = {};
+    std::atomic<ma_uint64> total{ 0 };
+    std::atomic<ma_uint64> late{ 0 };
+    std::atomic<ma_uint64> maxLate{ 0 };
+
+    static void bump(std::atomic<ma_uint64>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static size_t bucketOf(ma_uint64 frames) {
+        if (frames < exactFrames) return static_cast<size_t>(frames);
+        return exactFrames + std::bit_width(frames) - std::bit_width(exactFrames);
+    }
+
+    // Largest lateness that falls into bucket `i`.
+    static ma_uint64 bucketTop(size_t i) {
+        if (i < exactFrames) return i;
+        const int bits = static_cast<int>(i - exactFrames) + std::bit_width(exactFrames);
+        return bits >= 64 ? ~ma_uint64(0) : (ma_uint64(1) << bits) - 1;
+    }
+
+    // Counts are read one by one while the audio thread may still be
+    // recording, so a live snapshot is approximate by a few events.
+    ma_uint64 percentile(ma_uint64 count, ma_uint64 percent, ma_uint64 max) const {
+        if (count == 0) return 0;
+        const ma_uint64 rank = (count * percent + 99) / 100;
+        ma_uint64 seen = 0;
+        for (size_t i = 0; i < bucketCount; ++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return (std::min)(bucketTop(i), max);
+        }
+        return max;
+    }
+};
@@ -0,0 +1,231 @@
+#include "audio/Resampler.h"
+#include "audio/SampleBank.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WAVES_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static_assert(SampleBank::channels == 2, "the resampler kernels are written for stereo");
+
+bool parseInterpolation(const std::string& name, Interpolation& out) {
+    if (name == "linear") out = Interpolation::Linear;
+    else if (name == "cubic") out = Interpolation::Cubic;
+    else if (name == "sinc") out = Interpolation::Sinc;
+    else return false;
+    return true;
+}
+
+const char* interpolationName(Interpolation interpolation) {
+    switch (interpolation) {
+    case Interpolation::Linear: return "linear";
+    case Interpolation::Cubic: return "cubic";
+    case Interpolation::Sinc: return "sinc";
+    }
+    return "unknown";
+}
+
+ma_uint64 pitchToStep(double pitch) {
+    if (!(pitch > 0.0)) return phaseOne;
+    const double clamped = std::clamp(pitch, minPitch, maxPitch);
+    return static_cast<ma_uint64>(std::llround(clamped * static_cast<double>(phaseOne)));
+}
+
+// --- Sinc tables --------------------------------------------------------
+//
+// Taps sit at source offsets -3..+4 around the integer frame. Each phase row
+// stores every coefficient twice (L, R) so one SSE multiply covers a whole
+// stereo frame pair. Pitching up needs a lower cutoff, hence one table per
+// band.
+
+constexpr int sincTaps = 8;
+constexpr int sincHalf = sincTaps / 2;
+constexpr int sincPhaseBits = 8;
+constexpr int sincPhases = 1 << sincPhaseBits;
+constexpr double sincCutoffs[] = { 0.95, 0.7, 0.5, 0.35, 0.25 };
+constexpr ma_uint32 sincBands = sizeof(sincCutoffs) / sizeof(sincCutoffs[0]);
+
+alignas(16) static float g_sinc[sincBands][sincPhases][sincTaps * 2];
+static bool g_sinc_ready = false;
+
+static double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+void initResampler() {
+    if (g_sinc_ready) return;
+
+    const double pi = 3.14159265358979323846;
+    const double beta = 5.0;
+    for (ma_uint32 band = 0; band < sincBands; ++band) {
+        const double cutoff = sincCutoffs[band];
+        for (int p = 0; p < sincPhases; ++p) {
+            const double fraction = static_cast<double>(p) / sincPhases;
+            double taps[sincTaps];
+            double sum = 0.0;
+            for (int t = 0; t < sincTaps; ++t) {
+                const double x = (t - (sincHalf - 1)) - fraction;
+                const double sinc = x == 0.0 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+                const double r = x / sincHalf;
+                const double window = r * r < 1.0 ? besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta) : 0.0;
+                taps[t] = sinc * window;
+                sum += taps[t];
+            }
+            for (int t = 0; t < sincTaps; ++t) {
+                const float c = static_cast<float>(taps[t] / sum);
+                g_sinc[band][p][t * 2] = c;
+                g_sinc[band][p][t * 2 + 1] = c;
+            }
+        }
+    }
+    g_sinc_ready = true;
+}
+
+ma_uint32 sincBandForStep(ma_uint64 step) {
+    const double ratio = static_cast<double>(step) / phaseOne;
+    for (ma_uint32 band = 0; band < sincBands; ++band) {
+        if (sincCutoffs[band] * ratio <= 1.0) return band;
+    }
+    return sincBands - 1;
+}
+
+// --- Kernels -----------------------------------------------------------
+//
+// Each kernel has an unchecked fast path for frames whose whole footprint
+// lies inside the source, and a checked path near the edges.
+
+static inline float sampleAt(const float* pcm, ma_uint64 frameCount, ma_int64 frame, int channel) {
+    if (frame < 0 || static_cast<ma_uint64>(frame) >= frameCount) return 0.0f;
+    return pcm[frame * 2 + channel];
+}
+
+static inline float fractionOf(ma_uint64 phase) {
+    return static_cast<float>(phase & (phaseOne - 1)) * (1.0f / static_cast<float>(phaseOne));
+}
+
+static void linearFrame(const float* pcm, ma_uint64 frameCount, ma_uint64 phase, float* out) {
+    const ma_int64 i = static_cast<ma_int64>(phase >> phaseFractionBits);
+    const float t = fractionOf(phase);
+    const float* p = pcm + i * 2;
+    if (static_cast<ma_uint64>(i) + 1 < frameCount) {
+#ifdef WAVES_SSE2
+        // One load covers both frames: [aL aR bL bR].
+        const __m128 ab = _mm_loadu_ps(p);
+        const __m128 a = _mm_movelh_ps(ab, ab);
+        const __m128 b = _mm_movehl_ps(ab, ab);
+        const __m128 r = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t)));
+        _mm_storel_pi(reinterpret_cast<__m64*>(out), r);
+#else
+        out[0] = p[0] + (p[2] - p[0]) * t;
+        out[1] = p[1] + (p[3] - p[1]) * t;
+#endif
+        return;
+    }
+    for (int c = 0; c < 2; ++c) {
+        const float a = sampleAt(pcm, frameCount, i, c);
+        const float b = sampleAt(pcm, frameCount, i + 1, c);
+        out[c] = a + (b - a) * t;
+    }
+}
+
+static void cubicFrame(const float* pcm, ma_uint64 frameCount, ma_uint64 phase, float* out) {
+    const ma_int64 i = static_cast<ma_int64>(phase >> phaseFractionBits);
+    const float t = fractionOf(phase);
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    const float w0 = 0.5f * (-t3 + 2.0f * t2 - t);
+    const float w1 = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+    const float w2 = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+    const float w3 = 0.5f * (t3 - t2);
+
+    if (i >= 1 && static_cast<ma_uint64>(i) + 2 < frameCount) {
+        const float* p = pcm + (i - 1) * 2;
+#ifdef WAVES_SSE2
+        const __m128 lo = _mm_mul_ps(_mm_loadu_ps(p), _mm_setr_ps(w0, w0, w1, w1));
+        const __m128 hi = _mm_mul_ps(_mm_loadu_ps(p + 4), _mm_setr_ps(w2, w2, w3, w3));
+        const __m128 s = _mm_add_ps(lo, hi);
+        _mm_storel_pi(reinterpret_cast<__m64*>(out), _mm_add_ps(s, _mm_movehl_ps(s, s)));
+#else
+        out[0] = p[0] * w0 + p[2] * w1 + p[4] * w2 + p[6] * w3;
+        out[1] = p[1] * w0 + p[3] * w1 + p[5] * w2 + p[7] * w3;
+#endif
+        return;
+    }
+    for (int c = 0; c < 2; ++c) {
+        out[c] = sampleAt(pcm, frameCount, i - 1, c) * w0
+            + sampleAt(pcm, frameCount, i, c) * w1
+            + sampleAt(pcm, frameCount, i + 1, c) * w2
+            + sampleAt(pcm, frameCount, i + 2, c) * w3;
+    }
+}
+
+static void sincFrame(const float (*table)[sincTaps * 2], const float* pcm, ma_uint64 frameCount, ma_uint64 phase, float* out) {
+    const ma_int64 i = static_cast<ma_int64>(phase >> phaseFractionBits);
+    const float* c = table[(phase & (phaseOne - 1)) >> (phaseFractionBits - sincPhaseBits)];
+    const ma_int64 first = i - (sincHalf - 1);
+
+    if (first >= 0 && static_cast<ma_uint64>(first) + sincTaps <= frameCount) {
+        const float* p = pcm + first * 2;
+#ifdef WAVES_SSE2
+        __m128 s = _mm_mul_ps(_mm_loadu_ps(p), _mm_load_ps(c));
+        s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(p + 4), _mm_load_ps(c + 4)));
+        s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(p + 8), _mm_load_ps(c + 8)));
+        s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(p + 12), _mm_load_ps(c + 12)));
+        _mm_storel_pi(reinterpret_cast<__m64*>(out), _mm_add_ps(s, _mm_movehl_ps(s, s)));
+#else
+        float l = 0.0f, r = 0.0f;
+        for (int t = 0; t < sincTaps; ++t) {
+            l += p[t * 2] * c[t * 2];
+            r += p[t * 2 + 1] * c[t * 2 + 1];
+        }
+        out[0] = l;
+        out[1] = r;
+#endif
+        return;
+    }
+    for (int ch = 0; ch < 2; ++ch) {
+        float acc = 0.0f;
+        for (int t = 0; t < sincTaps; ++t) {
+            acc += sampleAt(pcm, frameCount, first + t, ch) * c[t * 2 + ch];
+        }
+        out[ch] = acc;
+    }
+}
+
+ma_uint32 resample(Interpolation interpolation, ma_uint32 sincBand,
+    const float* pcm, ma_uint64 frameCount, ma_uint64& phase, ma_uint64 step,
+    float* out, ma_uint32 frames) {
+    // Frames left before the integer part of the phase runs off the source.
+    const ma_uint64 end = frameCount << phaseFractionBits;
+    ma_uint32 count = 0;
+    if (phase < end) {
+        const ma_uint64 available = (end - phase + step - 1) / step;
+        count = available < frames ? static_cast<ma_uint32>(available) : frames;
+    }
+
+    ma_uint64 p = phase;
+    switch (interpolation) {
+    case Interpolation::Linear:
+        for (ma_uint32 n = 0; n < count; ++n, p += step) linearFrame(pcm, frameCount, p, out + n * 2);
+        break;
+    case Interpolation::Cubic:
+        for (ma_uint32 n = 0; n < count; ++n, p += step) cubicFrame(pcm, frameCount, p, out + n * 2);
+        break;
+    case Interpolation::Sinc: {
+        const auto table = g_sinc[sincBand < sincBands ? sincBand : sincBands - 1];
+        for (ma_uint32 n = 0; n < count; ++n, p += step) sincFrame(table, pcm, frameCount, p, out + n * 2);
+        break;
+    }
+    }
+
+    phase = p;
+    return count;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include <string>
+
+enum class Interpolation {
+    Linear,
+    Cubic, // Catmull-Rom
+    Sinc,  // 8-tap Kaiser-windowed sinc, polyphase tables
+};
+
+bool parseInterpolation(const std::string& name, Interpolation& out);
+const char* interpolationName(Interpolation interpolation);
+
+// Playback positions are 32.32 fixed point: the integer part is the source
+// frame, the low 32 bits the fraction. A step of `phaseOne` is unity pitch.
+constexpr int phaseFractionBits = 32;
+constexpr ma_uint64 phaseOne = ma_uint64(1) << phaseFractionBits;
+
+// Pitch ratios a voice may play at; pitchToStep() clamps to this range so
+// the step is never zero and never overflows.
+constexpr double minPitch = 1.0 / 64.0;
+constexpr double maxPitch = 64.0;
+
+ma_uint64 pitchToStep(double pitch);
+
+// Builds the sinc tables. Call once before rendering starts so the audio
+// thread never pays for it.
+void initResampler();
+
+// Picks the sinc table whose cutoff keeps a voice stepping by `step` from
+// aliasing.
+ma_uint32 sincBandForStep(ma_uint64 step);
+
+// Renders up to `frames` stereo frames from `pcm` starting at `phase`, which
+// is advanced by `step` per output frame. Samples outside the source read as
+// silence. Returns the number of frames written; fewer than `frames` means
+// the source is exhausted.
+ma_uint32 resample(Interpolation interpolation, ma_uint32 sincBand,
+    const float* pcm, ma_uint64 frameCount, ma_uint64& phase, ma_uint64 step,
+    float* out, ma_uint32 frames);
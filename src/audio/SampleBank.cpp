@@ -0,0 +1,100 @@
+#include "audio/SampleBank.h"
+
+#include <iostream>
+
+namespace {
+
+void decode(Sample& sample) {
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, SampleBank::channels, sample.sampleRate);
+    ma_uint64 frameCount = 0;
+    void* frames = NULL;
+    if (ma_decode_file(sample.path.c_str(), &config, &frameCount, &frames) != MA_SUCCESS) {
+        sample.state.store(SampleState::Failed, std::memory_order_release);
+        sample.state.notify_all();
+        return;
+    }
+
+    const float* first = static_cast<const float*>(frames);
+    sample.pcm.assign(first, first + frameCount * SampleBank::channels);
+    sample.data = sample.pcm.data();
+    sample.frameCount = frameCount;
+    ma_free(frames, NULL);
+
+    sample.state.store(SampleState::Ready, std::memory_order_release);
+    sample.state.notify_all();
+}
+
+}
+
+SampleHandle SampleBank::request(const std::string& path, ma_uint32 sampleRate) {
+    auto it = byPath.find(path);
+    if (it != byPath.end()) return it->second;
+
+    const SampleHandle handle = static_cast<SampleHandle>(samples.size());
+    auto sample = std::make_unique<Sample>();
+    sample->handle = handle;
+    sample->path = path;
+    sample->sampleRate = sampleRate;
+    Sample* target = sample.get();
+    samples.push_back(std::move(sample));
+    byPath.emplace(path, handle);
+
+    if (!pool) pool = std::make_unique<ThreadPool>();
+    pool->submit([target] { decode(*target); });
+    return handle;
+}
+
+bool SampleBank::attachBank(const std::string& path, ma_uint32 sampleRate) {
+    if (!bankFile.open(path)) return false;
+    if (bankFile.sampleRate() != sampleRate) {
+        std::cerr << "[BankError] " << path << " was built for " << bankFile.sampleRate()
+            << " Hz but the engine runs at " << sampleRate << " Hz.\n";
+        bankFile.close();
+        return false;
+    }
+    return true;
+}
+
+SampleHandle SampleBank::requestMapped(std::string_view name) {
+    const WvBankEntry* entry = bankFile.find(name);
+    if (!entry) return InvalidSample;
+
+    std::string key = bankFile.path() + ":" + std::string(name);
+    auto it = byPath.find(key);
+    if (it != byPath.end()) return it->second;
+
+    const SampleHandle handle = static_cast<SampleHandle>(samples.size());
+    auto sample = std::make_unique<Sample>();
+    sample->handle = handle;
+    sample->path = key;
+    sample->data = bankFile.pcm(*entry);
+    sample->frameCount = entry->frameCount;
+    sample->sampleRate = bankFile.sampleRate();
+    sample->mapped = true;
+    sample->state.store(SampleState::Ready, std::memory_order_relaxed);
+    samples.push_back(std::move(sample));
+    byPath.emplace(std::move(key), handle);
+    return handle;
+}
+
+const Sample* SampleBank::await(SampleHandle handle) {
+    if (handle >= samples.size()) return nullptr;
+    Sample& sample = *samples[handle];
+
+    SampleState state = sample.state.load(std::memory_order_acquire);
+    while (state == SampleState::Pending) {
+        sample.state.wait(SampleState::Pending, std::memory_order_acquire);
+        state = sample.state.load(std::memory_order_acquire);
+    }
+
+    if (!sample.reported) {
+        sample.reported = true;
+        if (state == SampleState::Ready) {
+            std::cout << (sample.mapped ? "[Audio] Mapped " : "[Audio] Decoded ") << sample.path << " (" << sample.frameCount << " frames @ "
+                << sample.sampleRate << " Hz)\n";
+        } else {
+            std::cerr << "[AudioError] Failed to decode: " << sample.path << "\n";
+        }
+    }
+    return state == SampleState::Ready ? &sample : nullptr;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include "audio/SampleBankFile.h"
+#include "common/ThreadPool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using SampleHandle = std::uint32_t;
+constexpr SampleHandle InvalidSample = UINT32_MAX;
+
+enum class SampleState : std::uint8_t {
+    Pending,
+    Ready,
+    Failed
+};
+
+// A decoded sample: interleaved float PCM at the engine sample rate.
+// `data` points either into `pcm`, filled by a decode worker, or into a
+// mapped .wvbank. `data` and `frameCount` may only be read once `state`
+// has been observed as Ready.
+struct Sample {
+    SampleHandle handle = InvalidSample;
+    std::string path;
+    std::vector<float> pcm;
+    const float* data = nullptr;
+    ma_uint64 frameCount = 0;
+    ma_uint32 sampleRate = 0;
+    std::atomic<SampleState> state{ SampleState::Pending };
+    bool mapped = false;
+    bool reported = false;
+};
+
+// Decodes every sample once, in parallel, and keeps it in memory. Handles
+// are dense indices handed out as soon as a file is requested, so
+// playback never touches the filesystem or a path lookup.
+class SampleBank {
+public:
+    static constexpr ma_uint32 channels = 2;
+
+    // Returns the handle of `path` immediately and queues its decode on the
+    // first request.
+    SampleHandle request(const std::string& path, ma_uint32 sampleRate);
+
+    // Maps a .wvbank built for `sampleRate`. Samples it contains can then
+    // be requested by name with requestMapped().
+    bool attachBank(const std::string& path, ma_uint32 sampleRate);
+
+    // Returns the handle of bank entry `name`, already Ready, or
+    // InvalidSample if no bank is attached or it has no such entry.
+    SampleHandle requestMapped(std::string_view name);
+
+    // Blocks until `handle` has been decoded. Returns null if decoding
+    // failed. Call from the control thread only.
+    const Sample* await(SampleHandle handle);
+
+    // Only valid for a handle that await() has returned.
+    const Sample& get(SampleHandle handle) const { return *samples[handle]; }
+
+private:
+    SampleBankFile bankFile;
+    // Samples are individually allocated so workers can fill one while
+    // the vector grows. Declared before `pool` so the workers are joined
+    // before any sample is freed.
+    std::vector<std::unique_ptr<Sample>> samples;
+    std::unordered_map<std::string, SampleHandle> byPath;
+    std::unique_ptr<ThreadPool> pool;
+};
@@ -0,0 +1,257 @@
+#include "audio/SampleBankFile.h"
+#include "audio/SampleBank.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char wvBankMagic[8] = { 'W', 'V', 'B', 'A', 'N', 'K', '\r', '\n' };
+
+std::uint64_t alignUp(std::uint64_t value) {
+    return (value + wvBankAlignment - 1) & ~static_cast<std::uint64_t>(wvBankAlignment - 1);
+}
+
+void pad(std::ofstream& out, std::uint64_t& position, std::uint64_t target) {
+    static const char zeros[wvBankAlignment] = {};
+    while (position < target) {
+        const std::uint64_t n = (std::min<std::uint64_t>)(target - position, sizeof(zeros));
+        out.write(zeros, static_cast<std::streamsize>(n));
+        position += n;
+    }
+}
+
+}
+
+bool buildSampleBankFile(const std::string& path, const std::string& directory, ma_uint32 sampleRate) {
+    if constexpr (std::endian::native != std::endian::little) {
+        std::cerr << "[BankError] .wvbank files can only be built on little-endian hosts.\n";
+        return false;
+    }
+
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(directory, error)) {
+        if (item.is_regular_file() && item.path().extension() == ".wav") files.push_back(item.path());
+    }
+    if (error) {
+        std::cerr << "[BankError] Cannot read " << directory << ": " << error.message() << "\n";
+        return false;
+    }
+    // Sorted by name, which is what SampleBankFile::find() relies on.
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.stem().string() < b.stem().string(); });
+
+    SampleBank decoder;
+    std::vector<SampleHandle> handles;
+    for (const auto& file : files) handles.push_back(decoder.request(file.string(), sampleRate));
+
+    struct Pending {
+        std::string name;
+        const Sample* sample;
+    };
+    std::vector<Pending> samples;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        const Sample* sample = decoder.await(handles[i]);
+        if (!sample) return false;
+        samples.push_back({ files[i].stem().string(), sample });
+    }
+
+    WvBankHeader header{};
+    std::memcpy(header.magic, wvBankMagic, sizeof(header.magic));
+    header.version = wvBankVersion;
+    header.sampleRate = sampleRate;
+    header.channels = SampleBank::channels;
+    header.entryCount = static_cast<std::uint32_t>(samples.size());
+    header.indexOffset = alignUp(sizeof(WvBankHeader));
+
+    std::vector<WvBankEntry> entries(samples.size());
+    std::uint32_t namesSize = 0;
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        entries[i].nameOffset = namesSize;
+        entries[i].nameLength = static_cast<std::uint32_t>(samples[i].name.size());
+        namesSize += entries[i].nameLength;
+    }
+    header.namesOffset = alignUp(header.indexOffset + entries.size() * sizeof(WvBankEntry));
+
+    std::uint64_t pcmOffset = alignUp(header.namesOffset + namesSize);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        entries[i].pcmOffset = pcmOffset;
+        entries[i].frameCount = samples[i].sample->frameCount;
+        pcmOffset = alignUp(pcmOffset + entries[i].frameCount * SampleBank::channels * sizeof(float));
+    }
+    header.fileSize = pcmOffset;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "[BankError] Cannot open " << path << " for writing.\n";
+        return false;
+    }
+
+    std::uint64_t position = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    position += sizeof(header);
+    pad(out, position, header.indexOffset);
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(WvBankEntry)));
+    position += entries.size() * sizeof(WvBankEntry);
+    pad(out, position, header.namesOffset);
+    for (const Pending& sample : samples) {
+        out.write(sample.name.data(), static_cast<std::streamsize>(sample.name.size()));
+        position += sample.name.size();
+    }
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        pad(out, position, entries[i].pcmOffset);
+        const std::uint64_t bytes = entries[i].frameCount * SampleBank::channels * sizeof(float);
+        out.write(reinterpret_cast<const char*>(samples[i].sample->data), static_cast<std::streamsize>(bytes));
+        position += bytes;
+    }
+    pad(out, position, header.fileSize);
+
+    if (!out) {
+        std::cerr << "[BankError] Failed writing " << path << ".\n";
+        return false;
+    }
+
+    std::cout << "[Bank] Wrote " << samples.size() << " sample(s), "
+        << static_cast<double>(header.fileSize) / (1024.0 * 1024.0) << " MB at "
+        << sampleRate << " Hz to " << path << "\n";
+    return true;
+}
+
+bool SampleBankFile::open(const std::string& path) {
+    close();
+    if (!mapFile(path)) return false;
+    filePath = path;
+    if (!validate()) {
+        std::cerr << "[BankError] " << path << " is not a valid .wvbank file.\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+const WvBankEntry* SampleBankFile::find(std::string_view wanted) const {
+    if (!base) return nullptr;
+    const WvBankEntry* first = entries();
+    const WvBankEntry* last = first + header().entryCount;
+    const WvBankEntry* it = std::lower_bound(first, last, wanted,
+        [this](const WvBankEntry& entry, std::string_view key) { return name(entry) < key; });
+    return it != last && name(*it) == wanted ? it : nullptr;
+}
+
+bool SampleBankFile::validate() const {
+    if constexpr (std::endian::native != std::endian::little) return false;
+    if (size < sizeof(WvBankHeader)) return false;
+
+    const WvBankHeader& h = header();
+    if (std::memcmp(h.magic, wvBankMagic, sizeof(h.magic)) != 0) return false;
+    if (h.version != wvBankVersion || h.channels != SampleBank::channels || h.fileSize != size) return false;
+    if (h.indexOffset % wvBankAlignment != 0 || h.indexOffset > size) return false;
+    if (h.entryCount > (size - h.indexOffset) / sizeof(WvBankEntry)) return false;
+    if (h.namesOffset < h.indexOffset + h.entryCount * sizeof(WvBankEntry) || h.namesOffset > size) return false;
+
+    const WvBankEntry* list = entries();
+    for (std::uint32_t i = 0; i < h.entryCount; ++i) {
+        const WvBankEntry& e = list[i];
+        if (e.nameOffset > size - h.namesOffset || e.nameLength > size - h.namesOffset - e.nameOffset) return false;
+        if (e.pcmOffset % wvBankAlignment != 0 || e.pcmOffset > size) return false;
+        if (e.frameCount > (size - e.pcmOffset) / (SampleBank::channels * sizeof(float))) return false;
+        if (i > 0 && !(name(list[i - 1]) < name(e))) return false;
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
+bool SampleBankFile::mapFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[BankError] Cannot open " << path << ".\n";
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = NULL;
+    const void* view = NULL;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!view) {
+        std::cerr << "[BankError] Cannot map " << path << ".\n";
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    base = static_cast<const std::byte*>(view);
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void SampleBankFile::close() {
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    base = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    filePath.clear();
+}
+
+#else
+
+bool SampleBankFile::mapFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[BankError] Cannot open " << path << ".\n";
+        return false;
+    }
+
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        std::cerr << "[BankError] Cannot map " << path << ".\n";
+        return false;
+    }
+
+    base = static_cast<const std::byte*>(view);
+    size = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void SampleBankFile::close() {
+    if (base) munmap(const_cast<std::byte*>(base), size);
+    base = nullptr;
+    size = 0;
+    filePath.clear();
+}
+
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// On-disk layout of a .wvbank file: pre-decoded, pre-resampled samples
+// that can be mapped straight into memory.
+//
+//   WvBankHeader                  at 0
+//   WvBankEntry[entryCount]       at indexOffset
+//   names, not NUL-terminated     at namesOffset
+//   interleaved f32 PCM           each run at its entry's pcmOffset
+//
+// Every section and PCM run starts on a 64-byte boundary, so runs begin
+// on a cache line and the float data is naturally aligned however the
+// file is mapped. All fields are little-endian.
+struct WvBankHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t sampleRate;
+    std::uint32_t channels;
+    std::uint32_t entryCount;
+    std::uint64_t indexOffset;
+    std::uint64_t namesOffset;
+    std::uint64_t fileSize;
+    std::uint8_t reserved[16];
+};
+
+struct WvBankEntry {
+    std::uint64_t pcmOffset;
+    std::uint64_t frameCount;
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::uint64_t reserved;
+};
+
+static_assert(sizeof(WvBankHeader) == 64, "WvBankHeader is part of the file format");
+static_assert(sizeof(WvBankEntry) == 32, "WvBankEntry is part of the file format");
+
+constexpr std::uint32_t wvBankVersion = 1;
+constexpr std::size_t wvBankAlignment = 64;
+
+// Decodes every .wav in `directory` at `sampleRate` (in parallel) and
+// writes them to `path`, named by file stem. Returns false on any error.
+bool buildSampleBankFile(const std::string& path, const std::string& directory, ma_uint32 sampleRate);
+
+// A .wvbank mapped read-only. The pages are shared with every other
+// process that maps the same file, and nothing is copied or decoded.
+class SampleBankFile {
+public:
+    SampleBankFile() = default;
+    ~SampleBankFile() { close(); }
+
+    SampleBankFile(const SampleBankFile&) = delete;
+    SampleBankFile& operator=(const SampleBankFile&) = delete;
+
+    // Maps and validates `path`; reports the reason and returns false if
+    // it is not a usable bank.
+    bool open(const std::string& path);
+    void close();
+
+    const std::string& path() const { return filePath; }
+    ma_uint32 sampleRate() const { return header().sampleRate; }
+
+    // Returns null if `name` is not in the bank.
+    const WvBankEntry* find(std::string_view name) const;
+    const float* pcm(const WvBankEntry& entry) const {
+        return reinterpret_cast<const float*>(base + entry.pcmOffset);
+    }
+
+private:
+    const std::byte* base = nullptr;
+    std::size_t size = 0;
+    std::string filePath;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    const WvBankHeader& header() const { return *reinterpret_cast<const WvBankHeader*>(base); }
+    const WvBankEntry* entries() const {
+        return reinterpret_cast<const WvBankEntry*>(base + header().indexOffset);
+    }
+    std::string_view name(const WvBankEntry& entry) const {
+        return { reinterpret_cast<const char*>(base + header().namesOffset + entry.nameOffset), entry.nameLength };
+    }
+
+    bool mapFile(const std::string& path);
+    bool validate() const;
+};
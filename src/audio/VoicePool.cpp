@@ -0,0 +1,74 @@
+#include "audio/VoicePool.h"
+
+bool parseStealPolicy(const std::string& name, StealPolicy& out) {
+    if (name == "oldest") out = StealPolicy::Oldest;
+    else if (name == "quietest") out = StealPolicy::Quietest;
+    else if (name == "same-sample") out = StealPolicy::SameSample;
+    else return false;
+    return true;
+}
+
+const char* stealPolicyName(StealPolicy policy) {
+    switch (policy) {
+    case StealPolicy::Oldest: return "oldest";
+    case StealPolicy::Quietest: return "quietest";
+    case StealPolicy::SameSample: return "same-sample";
+    }
+    return "unknown";
+}
+
+void VoicePool::init(const VoicePoolConfig& poolConfig) {
+    config = poolConfig;
+    if (config.maxVoices == 0) config.maxVoices = 1;
+    voices = std::make_unique<Voice[]>(config.maxVoices);
+}
+
+Voice* VoicePool::pickVictim(SampleHandle sample) {
+    Voice* oldest = nullptr;
+    Voice* oldestSame = nullptr;
+    Voice* quietest = nullptr;
+    float quietestLevel = 0.0f;
+
+    for (Voice& voice : *this) {
+        if (!oldest || voice.serial < oldest->serial) oldest = &voice;
+        if (voice.sample == sample && (!oldestSame || voice.serial < oldestSame->serial)) oldestSame = &voice;
+
+        const ma_uint64 position = voice.phase >> phaseFractionBits;
+        const float remaining = position < voice.frameCount
+            ? 1.0f - static_cast<float>(position) / voice.frameCount
+            : 0.0f;
+        const float level = voice.gain * remaining;
+        if (!quietest || level < quietestLevel) {
+            quietest = &voice;
+            quietestLevel = level;
+        }
+    }
+
+    switch (config.stealPolicy) {
+    case StealPolicy::Quietest: return quietest;
+    case StealPolicy::SameSample: return oldestSame ? oldestSame : oldest;
+    case StealPolicy::Oldest: break;
+    }
+    return oldest;
+}
+
+Voice* VoicePool::allocate(SampleHandle sample) {
+    Voice* voice = nullptr;
+    for (Voice& candidate : *this) {
+        if (!candidate.active) {
+            voice = &candidate;
+            break;
+        }
+    }
+
+    if (!voice) {
+        voice = pickVictim(sample);
+        ++stolen;
+    }
+
+    voice->serial = nextSerial++;
+    voice->sample = sample;
+    voice->phase = 0;
+    voice->active = true;
+    return voice;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include "audio/Resampler.h"
+#include "audio/SampleBank.h"
+#include <memory>
+#include <string>
+
+enum class StealPolicy {
+    Oldest,     // the voice triggered first
+    Quietest,   // lowest gain scaled by how much of the sample is left
+    SameSample, // the oldest voice already playing the same sample
+};
+
+bool parseStealPolicy(const std::string& name, StealPolicy& out);
+const char* stealPolicyName(StealPolicy policy);
+
+struct VoicePoolConfig {
+    ma_uint32 maxVoices = 32;
+    StealPolicy stealPolicy = StealPolicy::Oldest;
+};
+
+// One playing sample. Reads straight from SampleBank PCM; `phase` is the
+// 32.32 fixed-point source position and advances by `step` per output frame.
+struct Voice {
+    const float* pcm = nullptr;
+    ma_uint64 frameCount = 0;
+    ma_uint64 phase = 0;
+    ma_uint64 step = phaseOne;
+    ma_uint32 sincBand = 0;
+    ma_uint64 startFrame = 0;
+    ma_uint64 serial = 0;
+    SampleHandle sample = InvalidSample;
+    float gain = 1.0f;
+    bool active = false;
+};
+
+// Fixed-capacity polyphony, owned by the audio thread. All voices are
+// allocated by init(); allocate() never touches the heap and, once
+// `maxVoices` are busy, steals a victim according to the configured policy.
+class VoicePool {
+public:
+    void init(const VoicePoolConfig& config);
+
+    Voice* allocate(SampleHandle sample);
+
+    Voice* begin() { return voices.get(); }
+    Voice* end() { return voices.get() + config.maxVoices; }
+
+    ma_uint32 maxVoices() const { return config.maxVoices; }
+    ma_uint64 stolenCount() const { return stolen; }
+
+private:
+    VoicePoolConfig config;
+    std::unique_ptr<Voice[]> voices;
+    ma_uint64 nextSerial = 0;
+    ma_uint64 stolen = 0;
+
+    Voice* pickVictim(SampleHandle sample);
+};
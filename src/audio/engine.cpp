@@ -1,37 +1,140 @@
 #define MINIAUDIO_IMPLEMENTATION
 #include "libs/miniaudio.h"
 #include "audio/engine.h"
+#include "audio/Mixer.h"
+#include "audio/MixKernels.h"
+#include "audio/OfflineRenderer.h"
 
 #include <iostream>
 
-static ma_engine g_engine;
+static ma_device g_device;
+static Mixer g_mixer;
 static bool g_audio_init = false;
+static bool g_offline = false;
+static OfflineRenderer g_renderer;
+static ma_uint32 g_sample_rate = AudioConfig{}.sampleRate;
 
-void initAudio() {
-    if (!g_audio_init) {
-        if (ma_engine_init(NULL, &g_engine) == MA_SUCCESS) {
-            g_audio_init = true;
-            std::cout << "[Audio] Engine initialized.\n";
-        }
-        else {
-            std::cerr << "[AudioError] Failed to initialize engine.\n";
-        }
-    }
+static void dataCallback(ma_device* device, void* output, const void* input, ma_uint32 frameCount) {
+    (void)input;
+    static_cast<Mixer*>(device->pUserData)->render(static_cast<float*>(output), frameCount);
 }
 
-void playWav(const std::string& path) {
-    if (!g_audio_init) initAudio();
+void initAudio(const AudioConfig& config) {
+    if (g_audio_init) return;
 
-    if (ma_engine_play_sound(&g_engine, path.c_str(), NULL) != MA_SUCCESS) {
-        std::cerr << "[AudioError] Failed to play: " << path << "\n";
+    g_mixer.init(config);
+
+    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+    deviceConfig.playback.format = ma_format_f32;
+    deviceConfig.playback.channels = Mixer::channels;
+    deviceConfig.sampleRate = config.sampleRate;
+    deviceConfig.dataCallback = dataCallback;
+    deviceConfig.pUserData = &g_mixer;
+    deviceConfig.noPreSilencedOutputBuffer = MA_TRUE;
+
+    if (ma_device_init(NULL, &deviceConfig, &g_device) != MA_SUCCESS) {
+        std::cerr << "[AudioError] Failed to initialize device.\n";
         return;
     }
-    std::cout << "[Audio] Playing " << path << "\n";
+    if (ma_device_start(&g_device) != MA_SUCCESS) {
+        std::cerr << "[AudioError] Failed to start device.\n";
+        ma_device_uninit(&g_device);
+        return;
+    }
+
+    g_sample_rate = config.sampleRate;
+    g_audio_init = true;
+    std::cout << "[Audio] Device initialized (" << g_device.playback.name << ", "
+        << config.sampleRate << " Hz, " << config.voices.maxVoices << " voices, steal "
+        << stealPolicyName(config.voices.stealPolicy) << ", "
+        << selectedMixKernel().name << " mix kernel, "
+        << interpolationName(config.interpolation) << " interpolation).\n";
 }
 
-void shutdownAudio() {
+bool initOfflineAudio(const AudioConfig& config, const std::string& path, double seconds) {
+    if (g_audio_init) return false;
+
+    g_mixer.init(config);
+    if (!g_renderer.open(path, config.sampleRate, seconds)) return false;
+
+    g_sample_rate = config.sampleRate;
+    g_offline = true;
+    g_audio_init = true;
+    std::cout << "[Audio] Rendering " << seconds << " s to " << path << " ("
+        << config.sampleRate << " Hz, " << config.voices.maxVoices << " voices, "
+        << selectedMixKernel().name << " mix kernel, "
+        << interpolationName(config.interpolation) << " interpolation).\n";
+    return true;
+}
+
+bool audioOffline() {
+    return g_offline;
+}
+
+bool advanceAudioTo(ma_uint64 frame) {
+    if (!g_offline) return true;
+    return g_renderer.renderTo(g_mixer, frame);
+}
+
+bool audioInitialized() {
+    return g_audio_init;
+}
+
+ma_uint64 audioTimeInFrames() {
+    return g_mixer.framesRendered();
+}
+
+ma_uint32 audioSampleRate() {
+    return g_sample_rate;
+}
+
+bool scheduleSample(const Sample& sample, ma_uint64 startFrame, float gain, float pitch) {
+    if (!g_audio_init) initAudio();
+    if (!g_audio_init) return true; // nothing to wait for without an engine
+
+    AudioCommand command;
+    command.type = AudioCommand::Type::Trigger;
+    command.sample = sample.handle;
+    command.gain = gain;
+    command.pitch = pitch;
+    command.frame = startFrame;
+    command.pcm = sample.data;
+    command.frameCount = sample.frameCount;
+    return g_mixer.post(command);
+}
+
+void setMasterGain(float gain) {
+    if (!g_audio_init) return;
+
+    AudioCommand command;
+    command.type = AudioCommand::Type::SetMasterGain;
+    command.gain = gain;
+    g_mixer.post(command);
+}
+
+OnsetStats audioOnsetStats() {
+    return g_mixer.onsetStats();
+}
+
+bool shutdownAudio() {
+    bool ok = true;
     if (g_audio_init) {
-        ma_engine_uninit(&g_engine);
+        if (g_offline) {
+            ok = g_renderer.close(g_mixer);
+            g_offline = false;
+        }
+        else {
+            ma_device_uninit(&g_device);
+        }
         g_audio_init = false;
+        std::cout << "[Audio] Voices stolen: " << g_mixer.stolenCount()
+            << ", dropped: " << g_mixer.droppedCount() << "\n";
+
+        const OnsetStats onsets = g_mixer.onsetStats();
+        const double msPerFrame = 1000.0 / g_sample_rate;
+        std::cout << "[Audio] Onsets: " << onsets.count << ", late: " << onsets.late
+            << ", jitter p50 " << onsets.p50 << " / p99 " << onsets.p99 << " / max " << onsets.max
+            << " frames (max " << onsets.max * msPerFrame << " ms)\n";
     }
+    return ok;
 }
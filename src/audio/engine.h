@@ -1,7 +1,38 @@
 #pragma once
 #include "libs/miniaudio.h"
+#include "audio/AudioConfig.h"
+#include "audio/OnsetHistogram.h"
+#include "audio/SampleBank.h"
 #include <string>
 
-void initAudio();
-void playWav(const std::string& path);
-void shutdownAudio();
+void initAudio(const AudioConfig& config = {});
+// Returns false if an offline render could not be written out.
+bool shutdownAudio();
+bool audioInitialized();
+
+// Headless mode: no device, the engine renders `seconds` of audio into a
+// WAV file at `path`, driven by advanceAudioTo().
+bool initOfflineAudio(const AudioConfig& config, const std::string& path, double seconds);
+bool audioOffline();
+
+// Offline only: renders until the engine clock reaches `frame`. Returns
+// false once the requested length has been rendered.
+bool advanceAudioTo(ma_uint64 frame);
+
+// Absolute engine clock, in PCM frames at the engine sample rate.
+ma_uint64 audioTimeInFrames();
+ma_uint32 audioSampleRate();
+
+// Starts a decoded sample exactly at `startFrame` on the engine clock, at
+// `gain` and played back `pitch` times faster. The sample's PCM must outlive
+// playback. Returns false, and schedules nothing, while the engine already
+// holds as many future triggers as it can; retry once some have started.
+bool scheduleSample(const Sample& sample, ma_uint64 startFrame, float gain, float pitch);
+
+// Output gain applied on top of every voice's own gain.
+void setMasterGain(float gain);
+
+// How late voices have started against their scheduled frames since the
+// engine was initialized. Can be called at any time; shutdownAudio() also
+// prints it.
+OnsetStats audioOnsetStats();
@@ -0,0 +1,7 @@
+#pragma once
+
+// Microbenchmarks reachable from the command line (see main.cpp). Each one
+// prints its own report and returns a process exit code.
+int runMixBenchmark();
+int runLexerBenchmark();
+int runLoopBenchmark();
@@ -0,0 +1,134 @@
+#include "bench/Benchmarks.h"
+#include "lexer/Lexer.h"
+
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The classification the Lexer used before its lookup tables: a two-char
+// std::string hashed for every character, a char map for punctuation and a
+// std::string keyword map. Kept here only as the benchmark baseline.
+namespace {
+
+const std::unordered_map<char, TokenType> mapSingleChar = {
+	{'{', TokenType::LEFT_BRACE},
+	{'}', TokenType::RIGHT_BRACE},
+	{',', TokenType::COMMA},
+	{'.', TokenType::DOT},
+	{'/', TokenType::SLASH},
+	{';', TokenType::SEMICOLON}
+};
+
+const std::unordered_map<std::string, TokenType> mapDoubleChar = {
+	{"//", TokenType::COMMENT}
+};
+
+const std::unordered_map<std::string, TokenType> mapKeywords = {
+	{"play", TokenType::PLAY}, {"imp", TokenType::IMP}, {"as", TokenType::AS},
+	{"cpm", TokenType::CPM}, {"pattern", TokenType::PATTERN}, {"set", TokenType::SET},
+	{"sample", TokenType::SAMPLE}, {"volume", TokenType::VOLUME}, {"pitch", TokenType::PITCH},
+	{"loop", TokenType::LOOP},
+};
+
+size_t mapScan(const std::string& source) {
+	size_t count = 0;
+	size_t current = 0;
+	const size_t size = source.size();
+	auto peek = [&] { return current < size ? source[current] : '\0'; };
+
+	while (current < size) {
+		const size_t start = current;
+		const char c = source[current++];
+
+		std::string twoChars;
+		twoChars += c;
+		twoChars += peek();
+		if (mapDoubleChar.find(twoChars) != mapDoubleChar.end()) {
+			while (peek() != '\n' && current < size) current++;
+			continue;
+		}
+
+		if (mapSingleChar.find(c) != mapSingleChar.end()) {
+			++count;
+			continue;
+		}
+
+		if (c == '"') {
+			while (peek() != '"' && current < size) current++;
+			current++;
+			++count;
+		} else if (std::isdigit(static_cast<unsigned char>(c))) {
+			while (std::isdigit(static_cast<unsigned char>(peek()))) current++;
+			if (peek() == '.') {
+				current++;
+				while (std::isdigit(static_cast<unsigned char>(peek()))) current++;
+			}
+			++count;
+		} else if (std::isalpha(static_cast<unsigned char>(c))) {
+			while (std::isalnum(static_cast<unsigned char>(peek())) || peek() == '_') current++;
+			std::string text = source.substr(start, current - start);
+			auto it = mapKeywords.find(text);
+			(void)it;
+			++count;
+		}
+	}
+	return count + 1;
+}
+
+std::string generateProgram(int patterns) {
+	std::string source;
+	for (int i = 0; i < patterns; ++i) {
+		const std::string n = std::to_string(i);
+		source += "imp {\n    kick as k" + n + ",\n    snare as s" + n + ",\n    hi_hat as hh" + n + "\n}\n\n";
+		source += "cpm " + std::to_string(90 + i % 100) + ";\n\n";
+		source += "set d" + n + " {\n    volume 0.8;\n    pitch 1.25;\n}\n\n";
+		source += "loop {\n    play k" + n + ";\n    play hh" + n + ";\n    // backbeat\n    play s" + n + ";\n    wait 0.5;\n    play hh" + n + ";\n}\n\n";
+	}
+	return source;
+}
+
+} // namespace
+
+int runLexerBenchmark() {
+	using Clock = std::chrono::steady_clock;
+	constexpr int patterns = 5000;
+	constexpr int rounds = 20;
+
+	const std::string source = generateProgram(patterns);
+	const double megabytes = static_cast<double>(source.size()) / (1024.0 * 1024.0);
+
+	std::cout << "Lexer benchmark: " << patterns << " generated patterns, "
+		<< std::fixed << std::setprecision(2) << megabytes << " MB, " << rounds << " rounds\n";
+
+	size_t mapTokens = 0;
+	auto start = Clock::now();
+	for (int r = 0; r < rounds; ++r) mapTokens = mapScan(source);
+	const std::chrono::duration<double> mapTime = Clock::now() - start;
+
+	size_t tableTokens = 0;
+	start = Clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		Lexer lexer(source);
+		tableTokens = lexer.scanTokens().size();
+	}
+	const std::chrono::duration<double> tableTime = Clock::now() - start;
+
+	auto report = [&](const char* name, size_t tokens, double seconds) {
+		std::cout << "  " << std::left << std::setw(14) << name << std::right
+			<< std::setw(9) << megabytes * rounds / seconds << " MB/s"
+			<< std::setw(9) << tokens * rounds / seconds / 1e6 << " M tokens/s\n";
+	};
+	report("maps", mapTokens, mapTime.count());
+	report("tables+phash", tableTokens, tableTime.count());
+	std::cout << "  speedup " << mapTime.count() / tableTime.count() << "x\n";
+
+	if (mapTokens != tableTokens) {
+		std::cerr << "  token count mismatch: " << mapTokens << " vs " << tableTokens << "\n";
+		return 1;
+	}
+	return 0;
+}
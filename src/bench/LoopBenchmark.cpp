@@ -0,0 +1,61 @@
+#include "bench/Benchmarks.h"
+#include "interpreter/LoopVM.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// A busy pattern: 64 steps over 16 beats with triplet waits and a gain
+// or pitch change on most steps, so every opcode is exercised.
+LoopProgram buildPattern() {
+	LoopProgram program;
+	for (int step = 0; step < 64; ++step) {
+		program.emit(LoopOpcode::LoadK, 1, 0, program.constant(0.5 + 0.05 * (step % 8)));
+		if (step % 3 == 0) program.emit(LoopOpcode::LoadK, 2, 0, program.constant(1.0 + 0.1 * (step % 5)));
+		program.emit(LoopOpcode::Play, 1, 2, static_cast<std::uint32_t>(step % 4));
+		++program.playCount;
+		program.emit(LoopOpcode::Advance, 0, 0, program.step(step % 2 ? Rational{ 1, 3 } : Rational{ 1, 6 }));
+	}
+	program.emit(LoopOpcode::Halt, 0, 0, 0);
+	program.finish({ 16, 1 });
+	return program;
+}
+
+} // namespace
+
+int runLoopBenchmark() {
+	using Clock = std::chrono::steady_clock;
+	constexpr int cycles = 200000;
+	// Load to compare against: 256 tracks of this pattern at 200 cpm.
+	constexpr double tracks = 256.0;
+	constexpr double cpm = 200.0;
+
+	const LoopProgram program = buildPattern();
+	std::vector<LoopEvent> events;
+	events.reserve(program.playCount);
+
+	std::int64_t checksum = 0;
+	const auto start = Clock::now();
+	for (int c = 0; c < cycles; ++c) {
+		events.clear();
+		runLoopCycle(program, c * program.lengthTicks, events);
+		checksum += events.back().tick;
+	}
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+	const double eventsPerSecond = program.playCount * static_cast<double>(cycles) / elapsed.count();
+	const double neededPerSecond = tracks * program.playCount / program.lengthBeats.toDouble() * cpm / 60.0;
+
+	std::cout << "Loop VM benchmark: " << program.code.size() << " instructions, "
+		<< program.playCount << " events per cycle, " << cycles << " cycles\n"
+		<< std::fixed << std::setprecision(2)
+		<< "  " << eventsPerSecond / 1e6 << " M events/s ("
+		<< elapsed.count() * 1e9 / cycles / program.code.size() << " ns/instruction)\n"
+		<< "  " << static_cast<int>(tracks) << " tracks at " << static_cast<int>(cpm) << " cpm: "
+		<< std::setprecision(4) << 100.0 * neededPerSecond / eventsPerSecond << "% of one core\n";
+
+	return checksum > 0 ? 0 : 1;
+}
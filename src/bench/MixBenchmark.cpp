@@ -0,0 +1,106 @@
+#include "bench/Benchmarks.h"
+#include "audio/MixKernels.h"
+#include "audio/Resampler.h"
+#include "audio/SampleBank.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Mixes `voiceCount` distinct sources into one block, over and over, the way
+// the mixer does on every device callback.
+int runMixBenchmark() {
+    constexpr size_t channels = SampleBank::channels;
+    constexpr size_t blockFrames = 128;
+    constexpr size_t voiceCount = 64;
+    constexpr size_t sourceFrames = 48000;
+    constexpr double minSeconds = 0.5;
+
+    std::vector<float> sources(voiceCount * sourceFrames * channels);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        sources[i] = static_cast<float>((i * 2654435761u) % 2001) / 1000.0f - 1.0f;
+    }
+    std::vector<float> block(blockFrames * channels);
+
+    std::cout << "Mix benchmark: " << voiceCount << " voices, " << blockFrames
+        << "-frame stereo blocks\n";
+
+    using Clock = std::chrono::steady_clock;
+    double scalarRate = 0.0;
+
+    for (const MixKernelInfo& info : supportedMixKernels()) {
+        size_t blocks = 0;
+        size_t cursor = 0;
+        const auto start = Clock::now();
+        std::chrono::duration<double> elapsed{};
+
+        do {
+            for (int rep = 0; rep < 64; ++rep) {
+                std::fill(block.begin(), block.end(), 0.0f);
+                for (size_t v = 0; v < voiceCount; ++v) {
+                    const float* src = sources.data() + (v * sourceFrames + cursor) * channels;
+                    info.kernel(block.data(), src, blockFrames * channels, 0.5f);
+                }
+                cursor = (cursor + blockFrames) % (sourceFrames - blockFrames);
+                ++blocks;
+            }
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < minSeconds);
+
+        const double framesPerSecondPerVoice = static_cast<double>(blocks * blockFrames) / elapsed.count();
+        if (scalarRate == 0.0) scalarRate = framesPerSecondPerVoice;
+
+        std::cout << "  " << std::left << std::setw(8) << info.name << std::right
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << framesPerSecondPerVoice / 1e6 << " M frames/s per voice"
+            << std::setw(8) << framesPerSecondPerVoice / scalarRate << "x scalar"
+            << std::setw(10) << framesPerSecondPerVoice / 48000.0 << "x realtime @48k\n";
+    }
+
+    std::cout << "  selected: " << selectedMixKernel().name << "\n";
+
+    // Pitched voices: resample into a scratch block, then mix it, as the
+    // mixer does for every voice whose pitch is not 1.
+    const MixKernel mix = selectedMixKernel().kernel;
+    const double pitch = 1.8;
+    const ma_uint64 step = pitchToStep(pitch);
+    const ma_uint64 wrap = static_cast<ma_uint64>(sourceFrames - 16) << phaseFractionBits;
+    std::vector<float> scratch(blockFrames * channels);
+    initResampler();
+
+    std::cout << "Resample benchmark: " << voiceCount << " voices at pitch " << pitch << "\n";
+    for (Interpolation interpolation : { Interpolation::Linear, Interpolation::Cubic, Interpolation::Sinc }) {
+        std::vector<ma_uint64> phases(voiceCount, 0);
+        const ma_uint32 band = sincBandForStep(step);
+        size_t blocks = 0;
+        const auto start = Clock::now();
+        std::chrono::duration<double> elapsed{};
+
+        do {
+            for (int rep = 0; rep < 16; ++rep) {
+                std::fill(block.begin(), block.end(), 0.0f);
+                for (size_t v = 0; v < voiceCount; ++v) {
+                    if (phases[v] >= wrap) phases[v] = 0;
+                    const float* src = sources.data() + v * sourceFrames * channels;
+                    const ma_uint32 count = resample(interpolation, band, src, sourceFrames,
+                        phases[v], step, scratch.data(), blockFrames);
+                    mix(block.data(), scratch.data(), count * channels, 0.5f);
+                }
+                ++blocks;
+            }
+            elapsed = Clock::now() - start;
+        } while (elapsed.count() < minSeconds);
+
+        const double framesPerSecondPerVoice = static_cast<double>(blocks * blockFrames) / elapsed.count();
+        const double coreShare = 48000.0 / framesPerSecondPerVoice * 100.0;
+
+        std::cout << "  " << std::left << std::setw(8) << interpolationName(interpolation) << std::right
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << framesPerSecondPerVoice / 1e6 << " M frames/s per voice"
+            << std::setw(8) << coreShare << "% of one core for " << voiceCount << " voices @48k\n";
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for data that lives exactly as long as its owner.
+// Nothing allocated here is ever destroyed individually, so only
+// trivially destructible types may be placed in it; releasing the arena
+// frees a handful of blocks no matter how many objects they hold.
+class Arena {
+public:
+    explicit Arena(std::size_t blockSize = 16 * 1024) : blockSize(blockSize) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) noexcept = default;
+    Arena& operator=(Arena&&) noexcept = default;
+
+    void* allocate(std::size_t bytes, std::size_t align) {
+        std::size_t offset = (used + align - 1) & ~(align - 1);
+        if (blocks.empty() || offset + bytes > capacity) {
+            grow(bytes + align);
+            offset = (used + align - 1) & ~(align - 1);
+        }
+        void* p = blocks.back().get() + offset;
+        used = offset + bytes;
+        return p;
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Copies `items` into one contiguous run owned by the arena.
+    template <typename T>
+    std::span<const T> copy(const std::vector<T>& items) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        if (items.empty()) return {};
+        T* out = static_cast<T*>(allocate(sizeof(T) * items.size(), alignof(T)));
+        std::uninitialized_copy(items.begin(), items.end(), out);
+        return { out, items.size() };
+    }
+
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) return {};
+        char* out = static_cast<char*>(allocate(text.size(), 1));
+        std::memcpy(out, text.data(), text.size());
+        return { out, text.size() };
+    }
+
+private:
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::size_t blockSize;
+    std::size_t capacity = 0;
+    std::size_t used = 0;
+
+    void grow(std::size_t minBytes) {
+        capacity = minBytes > blockSize ? minBytes : blockSize;
+        blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(capacity));
+        used = 0;
+    }
+};
@@ -1,14 +1,40 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "common/Rational.h"
+#include "common/SymbolTable.h"
+#include "common/ParamOps.h"
 
 struct ImportEntry {
     std::string name;
     std::string alias;
     std::string path;
+    std::uint32_t sample = UINT32_MAX;
 };
 
+enum class ValueKind : std::uint8_t {
+    Number,
+    Identifier,
+    String
+};
+
+// A parameter value as the parser resolved it. Numbers carry both their
+// exact fraction and the nearest double; names carry their interned
+// symbol. `text` is the spelling from the source, kept for diagnostics
+// and printing.
+struct ParamValue {
+    ValueKind kind = ValueKind::String;
+    std::string_view text;
+    double number = 0.0;
+    Rational exact;
+    Symbol symbol = InvalidSymbol;
+};
+
+// Views into the owning Program's arena.
 struct ParamEntry {
-    std::string name;
-    std::string value;
+    std::string_view name;
+    ParamOp op = ParamOp::Unknown;
+    ParamValue value;
 };
@@ -0,0 +1,23 @@
+#include "ParamOps.h"
+#include "Entries.h"
+
+namespace {
+
+bool isNumber(const ParamValue& v) { return v.kind == ValueKind::Number; }
+bool isNonNegative(const ParamValue& v) { return isNumber(v) && v.exact.num >= 0; }
+// Same range the resampler clamps to (minPitch..maxPitch).
+bool isPitch(const ParamValue& v) {
+    return isNumber(v) && v.exact >= Rational{ 1, 64 } && v.exact <= Rational{ 64, 1 };
+}
+bool isName(const ParamValue& v) { return v.kind != ValueKind::Number; }
+
+}
+
+const std::array<ParamOpInfo, paramOpCount> paramOpTable = {{
+    { "", nullptr, "" },
+    { "sample", isName, "a string or identifier" },
+    { "volume", isNumber, "a number" },
+    { "pitch", isPitch, "a pitch ratio from 1/64 to 64" },
+    { "play", isName, "a sample alias" },
+    { "wait", isNonNegative, "a non-negative beat count" },
+}};
@@ -0,0 +1,44 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+struct ParamValue;
+
+// Every parameter or loop action name the language knows, resolved once
+// by the parser. To add an action (stop, mute, fx...): add an enumerator
+// before Count, a row in paramOpTable below, and a handler in the
+// interpreter's set/loop dispatch tables for the blocks it is valid in.
+enum class ParamOp : std::uint8_t {
+    Unknown,
+    Sample,
+    Volume,
+    Pitch,
+    Play,
+    Wait,
+    Count
+};
+
+constexpr std::size_t paramOpCount = static_cast<std::size_t>(ParamOp::Count);
+
+constexpr std::size_t opIndex(ParamOp op) {
+    return static_cast<std::size_t>(op);
+}
+
+struct ParamOpInfo {
+    std::string_view name;
+    // Checks the value at parse time; null accepts anything.
+    bool (*accepts)(const ParamValue&);
+    const char* expected;
+};
+
+// Indexed by ParamOp.
+extern const std::array<ParamOpInfo, paramOpCount> paramOpTable;
+
+inline ParamOp lookupParamOp(std::string_view name) {
+    for (std::size_t i = 1; i < paramOpCount; ++i) {
+        if (paramOpTable[i].name == name) return static_cast<ParamOp>(i);
+    }
+    return ParamOp::Unknown;
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <numeric>
+#include <string_view>
+
+// a * b into `out`; false if the product does not fit in 64 bits.
+inline constexpr bool checkedMul(std::int64_t a, std::int64_t b, std::int64_t& out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_mul_overflow(a, b, &out);
+#else
+    if (a == 0 || b == 0) {
+        out = 0;
+        return true;
+    }
+    const bool negative = (a < 0) != (b < 0);
+    const std::uint64_t ua = a < 0 ? 0 - static_cast<std::uint64_t>(a) : static_cast<std::uint64_t>(a);
+    const std::uint64_t ub = b < 0 ? 0 - static_cast<std::uint64_t>(b) : static_cast<std::uint64_t>(b);
+    const std::uint64_t limit = static_cast<std::uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+    if (ua > limit / ub) return false;
+    const std::uint64_t product = ua * ub;
+    out = static_cast<std::int64_t>(negative ? 0 - product : product);
+    return true;
+#endif
+}
+
+// a + b into `out`; false if the sum does not fit in 64 bits.
+inline constexpr bool checkedAdd(std::int64_t a, std::int64_t b, std::int64_t& out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_add_overflow(a, b, &out);
+#else
+    if ((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b)) return false;
+    out = a + b;
+    return true;
+#endif
+}
+
+// An exact fraction, always kept reduced with a positive denominator.
+struct Rational {
+    std::int64_t num = 0;
+    std::int64_t den = 1;
+
+    static constexpr Rational make(std::int64_t n, std::int64_t d) {
+        if (d < 0) { n = -n; d = -d; }
+        const std::int64_t g = std::gcd(n, d);
+        if (g > 1) { n /= g; d /= g; }
+        return { n, d };
+    }
+
+    double toDouble() const { return static_cast<double>(num) / static_cast<double>(den); }
+
+    // a + b into `out`; false if the result does not fit in 64 bits.
+    // Sums go through the lcm of the denominators, so beat positions that
+    // share a grid (quarters, triplets...) stay small however long they run.
+    friend constexpr bool checkedAdd(const Rational& a, const Rational& b, Rational& out) {
+        const std::int64_t g = std::gcd(a.den, b.den);
+        std::int64_t l = 0, x = 0, y = 0, n = 0;
+        if (!checkedMul(a.den / g, b.den, l) || !checkedMul(a.num, l / a.den, x)
+            || !checkedMul(b.num, l / b.den, y) || !checkedAdd(x, y, n) || n == INT64_MIN) {
+            return false;
+        }
+        out = make(n, l);
+        return true;
+    }
+
+    friend constexpr bool checkedSub(const Rational& a, const Rational& b, Rational& out) {
+        return b.num != INT64_MIN && checkedAdd(a, Rational{ -b.num, b.den }, out);
+    }
+
+    // a / b into `out`; false if b is zero or the result does not fit.
+    friend constexpr bool checkedDivide(const Rational& a, const Rational& b, Rational& out) {
+        std::int64_t n = 0, d = 0;
+        if (b.num == 0 || !checkedMul(a.num, b.den, n) || !checkedMul(a.den, b.num, d)) return false;
+        // make() negates both to fix the sign, which INT64_MIN cannot survive.
+        if (n == INT64_MIN || d == INT64_MIN) return false;
+        out = make(n, d);
+        return true;
+    }
+
+    friend constexpr bool operator==(const Rational&, const Rational&) = default;
+
+    friend constexpr bool operator<(const Rational& a, const Rational& b) {
+#ifdef __SIZEOF_INT128__
+        return static_cast<__int128>(a.num) * b.den < static_cast<__int128>(b.num) * a.den;
+#else
+        std::int64_t l = 0, r = 0;
+        if (checkedMul(a.num, b.den, l) && checkedMul(b.num, a.den, r)) return l < r;
+        return lessByDivision(a.num, a.den, b.num, b.den);
+#endif
+    }
+    friend constexpr bool operator>(const Rational& a, const Rational& b) { return b < a; }
+    friend constexpr bool operator<=(const Rational& a, const Rational& b) { return !(b < a); }
+    friend constexpr bool operator>=(const Rational& a, const Rational& b) { return !(a < b); }
+
+private:
+    // an/ad < bn/bd for positive denominators, without any product that
+    // could overflow: compares the integer parts, then the fractional
+    // parts through their reciprocals, as in a continued fraction.
+    static constexpr bool lessByDivision(std::int64_t an, std::int64_t ad, std::int64_t bn, std::int64_t bd) {
+        for (;;) {
+            std::int64_t aq = an / ad, ar = an % ad;
+            std::int64_t bq = bn / bd, br = bn % bd;
+            if (ar < 0) { --aq; ar += ad; }
+            if (br < 0) { --bq; br += bd; }
+            if (aq != bq) return aq < bq;
+            if (ar == 0 || br == 0) return ar == 0 && br != 0;
+            // ar/ad < br/bd exactly when bd/br < ad/ar.
+            an = bd; bn = ad;
+            ad = br; bd = ar;
+        }
+    }
+};
+
+// Reads "3", "-1.25" or "3/8" into an exact fraction. Anything else,
+// including a zero denominator or a value that does not fit in 64 bits,
+// is rejected.
+inline bool parseRational(std::string_view text, Rational& out) {
+    const auto slash = text.find('/');
+    if (slash != std::string_view::npos) {
+        Rational n, d;
+        return parseRational(text.substr(0, slash), n) && parseRational(text.substr(slash + 1), d)
+            && checkedDivide(n, d, out);
+    }
+
+    // The sign is taken off first: from_chars reads "-0" as plain 0, which
+    // would lose it for "-0.5".
+    if (!text.empty() && text.front() == '-') {
+        Rational magnitude;
+        if (text.size() < 2 || text[1] == '-' || !parseRational(text.substr(1), magnitude)) return false;
+        out = { -magnitude.num, magnitude.den };
+        return true;
+    }
+
+    std::int64_t whole = 0;
+    const char* first = text.data();
+    const char* last = first + text.size();
+    auto [p, ec] = std::from_chars(first, last, whole);
+    if (ec != std::errc() || p == first) return false;
+    if (p == last) {
+        out = { whole, 1 };
+        return true;
+    }
+
+    if (*p != '.') return false;
+    std::int64_t scale = 1;
+    std::int64_t fraction = 0;
+    for (++p; p != last; ++p) {
+        if (*p < '0' || *p > '9' || scale == 1000000000000000000) return false;
+        fraction = fraction * 10 + (*p - '0');
+        scale *= 10;
+    }
+    if (scale == 1 || whole > (INT64_MAX - fraction) / scale) return false;
+    out = Rational::make(whole * scale + fraction, scale);
+    return true;
+}
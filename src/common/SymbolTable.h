@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Dense id for an interned name. Ids start at 0 and are handed out in
+// first-seen order, so they can index flat per-program arrays.
+using Symbol = std::uint32_t;
+constexpr Symbol InvalidSymbol = UINT32_MAX;
+
+// Maps names to Symbols. The table does not own the text: callers add
+// names whose storage outlives it (the parser uses its Program's arena).
+class SymbolTable {
+public:
+    Symbol find(std::string_view name) const {
+        auto it = ids.find(name);
+        return it != ids.end() ? it->second : InvalidSymbol;
+    }
+
+    Symbol add(std::string_view storedName) {
+        const Symbol id = static_cast<Symbol>(names.size());
+        names.push_back(storedName);
+        ids.emplace(storedName, id);
+        return id;
+    }
+
+    std::string_view name(Symbol id) const { return names[id]; }
+    std::size_t size() const { return names.size(); }
+
+private:
+    std::unordered_map<std::string_view, Symbol> ids;
+    std::vector<std::string_view> names;
+};
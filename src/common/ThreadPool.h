@@ -0,0 +1,32 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining a FIFO of jobs. Meant for coarse
+// startup work such as decoding files, not for anything on the audio path.
+class ThreadPool {
+public:
+    // 0 uses one thread per hardware thread.
+    explicit ThreadPool(unsigned threads = 0);
+
+    // Drops jobs that have not started and joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> job);
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool stopping = false;
+
+    void work();
+};
@@ -1,181 +1,246 @@
 #include "Interpreter.h"
 #include <iostream>
 #include <filesystem>
-#include <chrono>
-#include <thread>
 #include <algorithm>
 #include <audio/engine.h>
 #include <cmath>
-#include <exception>
 
-Interpreter::Interpreter() {
-	initParamHandlers();
-	initLoopActions();
+const std::array<Interpreter::SetHandler, paramOpCount> Interpreter::setHandlers = [] {
+	std::array<SetHandler, paramOpCount> table{};
+	table[opIndex(ParamOp::Sample)] = &Interpreter::setSample;
+	table[opIndex(ParamOp::Volume)] = &Interpreter::setVolume;
+	table[opIndex(ParamOp::Pitch)] = &Interpreter::setPitch;
+	return table;
+}();
+
+const std::array<Interpreter::LoopHandler, paramOpCount> Interpreter::loopHandlers = [] {
+	std::array<LoopHandler, paramOpCount> table{};
+	table[opIndex(ParamOp::Play)] = &Interpreter::loopPlay;
+	table[opIndex(ParamOp::Wait)] = &Interpreter::loopWait;
+	return table;
+}();
+
+void Interpreter::setSample(const ParamEntry& p) {
+	currentSample = std::string(p.value.text);
+	std::cout << "  [set] sample -> " << currentSample << "\n";
 }
 
-void Interpreter::initParamHandlers() {
-	paramHandlers["sample"] = [this](const ParamEntry& p) {
-		currentSample = p.value;
-		std::cout << "  [set] sample -> " << currentSample << "\n";
-	};
-
-	paramHandlers["volume"] = [this](const ParamEntry& p) {
-		currentVolume = std::stod(p.value);
-		std::cout << "  [set] volume -> " << currentVolume << "\n";
-	};
+void Interpreter::setVolume(const ParamEntry& p) {
+	currentVolume = p.value.number;
+	std::cout << "  [set] volume -> " << currentVolume << "\n";
+}
 
-	paramHandlers["pitch"] = [this](const ParamEntry& p) {
-		currentPitch = std::stod(p.value);
-		std::cout << "  [set] pitch -> " << currentPitch << "\n";
-	};
+void Interpreter::setPitch(const ParamEntry& p) {
+	currentPitch = p.value.number;
+	std::cout << "  [set] pitch -> " << currentPitch << "\n";
 }
 
-void Interpreter::initLoopActions() {
-	loopActions["play"] = [this](const ParamEntry& p) {
-		const ImportEntry* entry = importManager.get(p.value);
-		if (!entry) {
-			std::cerr << "[RuntimeError] Unknown alias: " << p.value << "\n";
-			return;
-		}
-		playWav(entry->path);
-		std::cout << "  [loop] Playing " << p.value
+void Interpreter::loopPlay(const ParamEntry& p, LoopBuilder& loop) {
+	const ImportEntry* entry = importManager.get(p.value.symbol);
+	if (!entry) {
+		reportUnbound(p.value.symbol, p.value.text);
+	} else if (importManager.awaitSample(entry->sample)) {
+		// Only samples a loop actually plays are waited for; the rest of
+		// the kit keeps decoding in the background.
+		loop.play(entry->sample, currentVolume, currentPitch);
+		std::cout << "  [loop] Play " << p.value.text
 			<< " -> " << entry->path
+			<< " @ beat " << loop.offsetBeats.toDouble()
 			<< " (vol=" << currentVolume
 			<< ", pitch=" << currentPitch << ")\n";
+	}
+
+	// A step whose sample is missing still takes its beat.
+	loop.advance({ 1, 1 });
+}
+
+void Interpreter::loopWait(const ParamEntry& p, LoopBuilder& loop) {
+	loop.advance(p.value.exact);
+	std::cout << "  [loop] Wait " << p.value.number << " beat(s)\n";
+}
+
+void Interpreter::interpret(const Program& program) {
+	importManager.reset(program.symbols().size());
+	checkAliases(program);
+
+	for (const Stmt& stmt : program.statements()) {
+		visitStmt(*this, stmt);
+	}
+
+	// Loops only register tracks while the program runs; they all start
+	// together once every statement has been executed.
+	if (sequencer.trackCount() > 0) {
+		std::cout << "[LOOP] Playing " << sequencer.trackCount() << " track(s).\n";
+		sequencer.run();
+		std::cout << "[LOOP] End of loop.\n";
+	}
+}
+
+// Reports every alias that is used before any `imp` declares it, so
+// typos surface before playback starts rather than when a beat reaches
+// them.
+void Interpreter::checkAliases(const Program& program) {
+	declaredAliases.assign(program.symbols().size(), false);
+
+	auto check = [&](Symbol symbol, std::string_view alias) {
+		if (symbol != InvalidSymbol && !declaredAliases[symbol]) {
+			std::cerr << "[NameError] Unknown alias: " << alias << "\n";
+		}
 	};
+
+	for (const Stmt& stmt : program.statements()) {
+		if (const auto* imp = std::get_if<ImportStmt>(&stmt)) {
+			for (const auto& entry : imp->entries) declaredAliases[entry.symbol] = true;
+		} else if (const auto* play = std::get_if<PlayStmt>(&stmt)) {
+			check(play->symbol, play->alias);
+		} else if (const auto* loop = std::get_if<LoopStmt>(&stmt)) {
+			for (const auto& param : loop->params) {
+				if (param.op == ParamOp::Play) check(param.value.symbol, param.value.text);
+			}
+		}
+	}
 }
 
+// Undeclared aliases were already reported by checkAliases(); what is left
+// are declared imports whose file failed to load.
+void Interpreter::reportUnbound(Symbol symbol, std::string_view alias) const {
+	if (symbol < declaredAliases.size() && declaredAliases[symbol]) {
+		std::cerr << "[RuntimeError] No sample loaded for alias: " << alias << "\n";
+	}
+}
 
-void Interpreter::interpret(const std::vector<std::unique_ptr<Stmt>>& statements) {
-        for (const auto& stmt : statements) {
-		if (stmt) stmt->accept(*this);
+static std::string samplePath(std::string_view name) {
+	return "src/vendor/" + std::string(name) + ".wav";
+}
+
+bool Interpreter::attachBank(const std::string& path, ma_uint32 sampleRate) {
+	return importManager.attachBank(path, sampleRate);
+}
+
+// Resolves import `name` to a sample: the attached bank's entry if it has
+// one, otherwise src/vendor/<name>.wav queued for decoding. `source` is
+// set to where the sample comes from either way.
+SampleHandle Interpreter::requestImport(std::string_view name, ma_uint32 sampleRate, std::string& source) {
+	SampleHandle sample = importManager.requestMapped(name);
+	if (sample != InvalidSample) {
+		source = importManager.sample(sample).path;
+		return sample;
+	}
+
+	source = samplePath(name);
+	if (!std::filesystem::exists(source)) return InvalidSample;
+	return importManager.requestSample(source, sampleRate);
+}
+
+void Interpreter::prefetch(const Program& program, ma_uint32 sampleRate) {
+	std::string source;
+	for (const Stmt& stmt : program.statements()) {
+		const auto* imp = std::get_if<ImportStmt>(&stmt);
+		if (!imp) continue;
+		for (const auto& entry : imp->entries) requestImport(entry.name, sampleRate, source);
 	}
 }
 
-void Interpreter::visitImportStmt(ImportStmt& stmt) {
+// Binds each alias to its sample without waiting for the decode; loops
+// wait for the samples they actually use when they are compiled.
+void Interpreter::visit(const ImportStmt& stmt) {
 	for (const auto& entry : stmt.entries) {
-		std::string path = "src/vendor/" + entry.name + ".wav";
-		if (!std::filesystem::exists(path)) {
+		std::string path;
+		SampleHandle sample = requestImport(entry.name, audioSampleRate(), path);
+		if (sample == InvalidSample) {
 			std::cerr << "[ImportError] file not found: " << path << "\n";
 			continue;
 		}
 
 		ImportEntry record {
-			entry.name,
-			entry.alias,
-			path
+			std::string(entry.name),
+			std::string(entry.alias),
+			path,
+			sample
 		};
 
-		importManager.addImport(entry.alias, record);
+		importManager.addImport(entry.symbol, std::move(record));
 		std::cout << "Imported " << entry.name << " as " << entry.alias << "\n";
 	}
 }
 
-void Interpreter::visitPlayStmt(PlayStmt& stmt) {
-	const ImportEntry* entry = importManager.get(stmt.alias);
+void Interpreter::visit(const PlayStmt& stmt) {
+	const ImportEntry* entry = importManager.get(stmt.symbol);
 	if (!entry) {
-		std::cerr << "[RuntimeError] Unknown alias: " << stmt.alias << "\n";
+		reportUnbound(stmt.symbol, stmt.alias);
 		return;
 	}
 
 	std::cout << "Playing sample: " << stmt.alias << " (" << entry->path << ")\n";
 }
 
-void Interpreter::visitSetStmt(SetStmt& stmt) {
+void Interpreter::visit(const SetStmt& stmt) {
 	std::cout << "Setting " << stmt.alias << ":\n";
 	for (const auto& param : stmt.params) {
-		auto it = paramHandlers.find(param.name);
-		if (it != paramHandlers.end()) {
-			it->second(param);
-		}else {
+		const SetHandler handler = setHandlers[opIndex(param.op)];
+		if (handler) {
+			(this->*handler)(param);
+		} else {
 			std::cerr << "[Warning] Unknown parameter: " << param.name << "\n";
 		}
 	}
 }
 
-void Interpreter::visitCpmStmt(CpmStmt& stmt) {
-	cpm = stmt.value;
-	std::cout << "[CPM] CPM set to " << cpm << "\n";
-}
+void Interpreter::visit(const CpmStmt& stmt) {
+	if (!stmt.change) {
+		tempo = TempoMap(stmt.value);
+		std::cout << "[CPM] CPM set to " << stmt.value.toDouble() << "\n";
+		return;
+	}
 
-void Interpreter::visitLoopStmt(LoopStmt& stmt) {
-        std::cout << "[LOOP] Starting loop at " << cpm << " CPM.\n";
+	if (!tempo.addChange(stmt.atBeat, stmt.value, stmt.rampBeats, stmt.shape)) {
+		std::cerr << "[TempoError] Tempo change at beat " << stmt.atBeat.toDouble()
+			<< " overlaps or precedes an earlier change.\n";
+		return;
+	}
+	std::cout << "[CPM] CPM -> " << stmt.value.toDouble() << " at beat " << stmt.atBeat.toDouble();
+	if (stmt.rampBeats.num > 0) {
+		std::cout << " (" << (stmt.shape == RampShape::Exponential ? "exponential" : "linear")
+			<< " ramp over " << stmt.rampBeats.toDouble() << " beat(s))";
+	}
+	std::cout << "\n";
+}
 
-        const double beatDurationMs = (60.0 / cpm) * 1000.0;
+void Interpreter::visit(const LoopStmt& stmt) {
+        std::cout << "[LOOP] Starting loop at " << tempo.initialCpm() << " CPM";
+        if (tempo.changeCount() > 0) std::cout << " with " << tempo.changeCount() << " tempo change(s)";
+        std::cout << ".\n";
 
-        const size_t stepCount = stmt.params.size();
-        if (stepCount == 0) {
+        if (stmt.params.empty()) {
                 std::cerr << "[LoopError] Empty loop block.\n";
                 return;
         }
 
-        while (true) {
-            double offsetBeats = 0.0;
-            double maxBeats = 0.0;
-
-            for (const auto& action : stmt.params) {
-                if (action.name == "wait") {
-                    double beatsToWait = parseBeatValue(action.value);
-                    if (beatsToWait < 0.0) {
-                        std::cerr << "[LoopError] Invalid wait value: " << action.value << "\n";
-                        continue;
-                    }
-
-                    offsetBeats += beatsToWait;
-                    maxBeats = (std::max)(maxBeats, offsetBeats);
-
-                    std::cout << "  [loop] Waiting " << beatsToWait << " beat(s)\n";
-                    continue;
-                }
-
-                auto it = loopActions.find(action.name);
-                if (it == loopActions.end()) {
-                    std::cerr << "[Warning] Unknown loop action: " << action.name << "\n";
-                    continue;
-                }
-
-                double actionOffsetMs = offsetBeats * beatDurationMs;
-
-                std::thread([=]() {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(std::round(actionOffsetMs))));
-                    it->second(action);
-                    }).detach();
+        LoopProgram program;
+        if (!compileLoop(stmt, program)) return;
 
-                offsetBeats += 1.0;
-                maxBeats = (std::max)(maxBeats, offsetBeats);
-            }
-
-            double loopDurationBeats = (std::max)(1.0, maxBeats);
-            auto sleepDurationMs = static_cast<int>(std::round(loopDurationBeats * beatDurationMs));
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(sleepDurationMs));
-        }
-
-        std::cout << "[LOOP] End of loop.\n";
+        sequencer.addTrack(std::move(program), tempo);
+        std::cout << "[LOOP] Registered as track " << sequencer.trackCount() << ".\n";
 }
 
-double Interpreter::parseBeatValue(const std::string& value) const {
-    if (value.empty()) {
-        return 0.0;
-    }
+bool Interpreter::compileLoop(const LoopStmt& stmt, LoopProgram& program) {
+        LoopBuilder loop{ program };
 
-    const auto slashPos = value.find('/');
-    if (slashPos != std::string::npos) {
-        try {
-            double numerator = std::stod(value.substr(0, slashPos));
-            double denominator = std::stod(value.substr(slashPos + 1));
-            if (denominator == 0.0) {
-                 return -1.0;
+        for (const auto& action : stmt.params) {
+            const LoopHandler handler = loopHandlers[opIndex(action.op)];
+            if (!handler) {
+                std::cerr << "[Warning] Unknown loop action: " << action.name << "\n";
+                continue;
             }
-            return numerator / denominator;
-        } catch (const std::exception&) {
-                return -1.0;
+            (this->*handler)(action, loop);
         }
-    }
 
-    try {
-        return std::stod(value);
-    } catch (const std::exception&) {
-         return -1.0;
-    }
+        program.emit(LoopOpcode::Halt, 0, 0, 0);
+        if (loop.overflowed || !program.finish((std::max)(Rational{ 1, 1 }, loop.maxBeats))) {
+            std::cerr << "[LoopError] Step lengths are too finely divided to share a beat grid.\n";
+            return false;
+        }
+        std::cout << "[LOOP] Compiled " << program.playCount << " event(s) over "
+            << program.lengthBeats.toDouble() << " beat(s).\n";
+        return true;
 }
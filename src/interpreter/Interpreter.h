@@ -1,38 +1,109 @@
 #pragma once
 #include "parser/Stmt.h"
+#include "interpreter/LoopProgram.h"
+#include "interpreter/Sequencer.h"
 #include "runtime/ImportManager.h"
+#include "runtime/Scheduler.h"
 #include <vector>
 #include <memory>
-#include <unordered_map>
-#include <functional>
+#include <algorithm>
+#include <array>
 #include <string>
 #include <iostream>
 
-class Interpreter : public StmtVisitor {
+class Interpreter {
 public:
-    Interpreter();
+    // Serves imports from a .wvbank file where it has them. Call before
+    // prefetch()/interpret().
+    bool attachBank(const std::string& path, ma_uint32 sampleRate);
 
-    void interpret(const std::vector<std::unique_ptr<Stmt>>& statements);
+    // Queues background decodes for every file the program imports, so
+    // they overlap with audio device start-up. Optional: imports that were
+    // not prefetched are requested when their statement runs.
+    void prefetch(const Program& program, ma_uint32 sampleRate);
 
-    void visitImportStmt(ImportStmt& stmt) override;
-    void visitPlayStmt(PlayStmt& stmt) override;
-    void visitSetStmt(SetStmt& stmt) override;
-    void visitCpmStmt(CpmStmt& stmt) override;
-    void visitLoopStmt(LoopStmt& stmt) override;
+    void setLookaheadMs(double ms) { scheduler.setLookaheadMs(ms); }
+    void setVerbose(bool on) { sequencer.setVerbose(on); }
+
+    void interpret(const Program& program);
+
+    void visit(const ImportStmt& stmt);
+    void visit(const PlayStmt& stmt);
+    void visit(const SetStmt& stmt);
+    void visit(const CpmStmt& stmt);
+    void visit(const LoopStmt& stmt);
 
 private:
     ImportManager importManager;
+    Scheduler scheduler;
+    Sequencer sequencer{ scheduler, importManager };
 
-    int cpm = 120;
+    // Tempo for loops registered from here on; each track keeps a copy.
+    TempoMap tempo;
     double currentVolume = 1.0;
     double currentPitch = 1.0;
     std::string currentSample;
 
-    std::unordered_map<std::string, std::function<void(const ParamEntry&)>> paramHandlers;
-    std::unordered_map<std::string, std::function<void(const ParamEntry&)>> loopActions;
+    // Cursor used while compiling one loop block to bytecode. Gain and
+    // pitch live in fixed registers and are only reloaded when they change.
+    struct LoopBuilder {
+        static constexpr std::uint8_t gainRegister = 1;
+        static constexpr std::uint8_t pitchRegister = 2;
+
+        LoopProgram& program;
+        Rational offsetBeats{};
+        Rational maxBeats{};
+        // Set once the cursor no longer fits in a 64-bit fraction; the
+        // loop is then rejected.
+        bool overflowed = false;
+        bool registersLoaded = false;
+        double loadedGain = 0.0;
+        double loadedPitch = 0.0;
+
+        void advance(Rational beats) {
+            if (!checkedAdd(offsetBeats, beats, offsetBeats)) {
+                overflowed = true;
+                return;
+            }
+            maxBeats = (std::max)(maxBeats, offsetBeats);
+            program.emit(LoopOpcode::Advance, 0, 0, program.step(beats));
+        }
+
+        void play(SampleHandle sample, double gain, double pitch) {
+            if (!registersLoaded || gain != loadedGain) {
+                program.emit(LoopOpcode::LoadK, gainRegister, 0, program.constant(gain));
+                loadedGain = gain;
+            }
+            if (!registersLoaded || pitch != loadedPitch) {
+                program.emit(LoopOpcode::LoadK, pitchRegister, 0, program.constant(pitch));
+                loadedPitch = pitch;
+            }
+            registersLoaded = true;
+            program.emit(LoopOpcode::Play, gainRegister, pitchRegister, sample);
+            ++program.playCount;
+        }
+    };
+
+    using SetHandler = void (Interpreter::*)(const ParamEntry&);
+    using LoopHandler = void (Interpreter::*)(const ParamEntry&, LoopBuilder&);
+
+    // Indexed by ParamOp; a null slot means the op is not valid in that
+    // kind of block. Loop handlers run once, at compile time.
+    static const std::array<SetHandler, paramOpCount> setHandlers;
+    static const std::array<LoopHandler, paramOpCount> loopHandlers;
+
+    // Indexed by Symbol: true once an `imp` block names it.
+    std::vector<bool> declaredAliases;
+
+    void setSample(const ParamEntry& p);
+    void setVolume(const ParamEntry& p);
+    void setPitch(const ParamEntry& p);
+    void loopPlay(const ParamEntry& p, LoopBuilder& loop);
+    void loopWait(const ParamEntry& p, LoopBuilder& loop);
+
+    SampleHandle requestImport(std::string_view name, ma_uint32 sampleRate, std::string& source);
+    void checkAliases(const Program& program);
+    void reportUnbound(Symbol symbol, std::string_view alias) const;
 
-    void initParamHandlers();
-    void initLoopActions();
-    
-    double parseBeatValue(const std::string& value) const;
+    bool compileLoop(const LoopStmt& stmt, LoopProgram& program);
 };
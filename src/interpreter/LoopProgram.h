@@ -0,0 +1,97 @@
+#pragma once
+#include "audio/SampleBank.h"
+#include "common/Rational.h"
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Instruction set of the loop VM. Registers hold doubles; the beat cursor
+// is kept apart as a whole number of ticks from the start of the cycle.
+enum class LoopOpcode : std::uint8_t {
+	LoadK,   // r[a] = k[c]
+	Advance, // cursor += stepTicks[c]
+	Play,    // emit sample c at the cursor with gain r[a] and pitch r[b]
+	Halt,    // end of cycle
+	Count
+};
+
+constexpr std::uint8_t loopRegisterCount = 16;
+
+struct LoopInstr {
+	LoopOpcode op = LoopOpcode::Halt;
+	std::uint8_t a = 0;
+	std::uint8_t b = 0;
+	std::uint32_t c = 0;
+};
+
+static_assert(sizeof(LoopInstr) == 8, "LoopInstr is meant to stay 8 bytes");
+
+// A loop body compiled to bytecode. Each cycle the VM runs `code` once
+// from the top; no text is parsed and nothing is allocated.
+//
+// Step lengths are collected as exact fractions and, once the body is
+// complete, put on one tick grid whose resolution is the lcm of their
+// denominators. Positions are then plain integers: cycle n starts on tick
+// n * lengthTicks exactly, however many cycles have gone before.
+struct LoopProgram {
+	std::vector<LoopInstr> code;
+	std::vector<double> constants;
+	std::vector<Rational> steps;
+	std::vector<std::int64_t> stepTicks;
+	std::uint32_t playCount = 0;
+	Rational lengthBeats{ 1, 1 };
+	std::int64_t ticksPerBeat = 1;
+	std::int64_t lengthTicks = 1;
+
+	std::uint32_t constant(double value) {
+		for (std::uint32_t i = 0; i < constants.size(); ++i) {
+			if (constants[i] == value) return i;
+		}
+		constants.push_back(value);
+		return static_cast<std::uint32_t>(constants.size() - 1);
+	}
+
+	std::uint32_t step(Rational beats) {
+		for (std::uint32_t i = 0; i < steps.size(); ++i) {
+			if (steps[i] == beats) return i;
+		}
+		steps.push_back(beats);
+		return static_cast<std::uint32_t>(steps.size() - 1);
+	}
+
+	void emit(LoopOpcode op, std::uint8_t a, std::uint8_t b, std::uint32_t c) {
+		code.push_back({ op, a, b, c });
+	}
+
+	// Sets the cycle length and builds the tick grid. Fails if the steps
+	// share no grid that fits in 64 bits.
+	bool finish(Rational length) {
+		std::int64_t grid = length.den;
+		for (const Rational& s : steps) {
+			if (!checkedMul(grid / std::gcd(grid, s.den), s.den, grid)) return false;
+		}
+
+		std::int64_t ticks = 0;
+		stepTicks.clear();
+		for (const Rational& s : steps) {
+			if (!checkedMul(s.num, grid / s.den, ticks)) return false;
+			stepTicks.push_back(ticks);
+		}
+		if (!checkedMul(length.num, grid / length.den, ticks)) return false;
+		lengthBeats = length;
+		ticksPerBeat = grid;
+		lengthTicks = ticks;
+		return true;
+	}
+
+	Rational beatAtTick(std::int64_t tick) const { return Rational::make(tick, ticksPerBeat); }
+};
+
+// What the VM hands the scheduler: one sample trigger at an absolute tick
+// of its program's grid.
+struct LoopEvent {
+	std::int64_t tick = 0;
+	SampleHandle sample = InvalidSample;
+	float gain = 1.0f;
+	float pitch = 1.0f;
+};
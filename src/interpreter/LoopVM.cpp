@@ -0,0 +1,64 @@
+#include "LoopVM.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WAVES_COMPUTED_GOTO 1
+#endif
+
+void runLoopCycle(const LoopProgram& program, std::int64_t cycleTick, std::vector<LoopEvent>& out) {
+	double r[loopRegisterCount] = {};
+	std::int64_t cursor = cycleTick;
+	const LoopInstr* ip = program.code.data();
+	const double* k = program.constants.data();
+	const std::int64_t* steps = program.stepTicks.data();
+
+	if (program.code.empty()) return;
+
+#ifdef WAVES_COMPUTED_GOTO
+	// Same order as LoopOpcode.
+	static void* const labels[] = { &&op_LoadK, &&op_Advance, &&op_Play, &&op_Halt };
+	static_assert(sizeof(labels) / sizeof(labels[0]) == static_cast<size_t>(LoopOpcode::Count));
+#define DISPATCH() goto *labels[static_cast<std::uint8_t>(ip->op)]
+#define CASE(name) op_##name:
+#define NEXT() ++ip; DISPATCH()
+
+	DISPATCH();
+#else
+#define CASE(name) case LoopOpcode::name:
+#define NEXT() ++ip; continue
+
+	for (;;) {
+		switch (ip->op) {
+#endif
+
+	CASE(LoadK) {
+		r[ip->a] = k[ip->c];
+		NEXT();
+	}
+	CASE(Advance) {
+		cursor += steps[ip->c];
+		NEXT();
+	}
+	CASE(Play) {
+		out.push_back({
+			cursor,
+			ip->c,
+			static_cast<float>(r[ip->a]),
+			static_cast<float>(r[ip->b])
+		});
+		NEXT();
+	}
+	CASE(Halt) {
+		return;
+	}
+
+#ifndef WAVES_COMPUTED_GOTO
+		default:
+			return;
+		}
+	}
+#endif
+
+#undef CASE
+#undef NEXT
+#undef DISPATCH
+}
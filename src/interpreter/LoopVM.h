@@ -0,0 +1,8 @@
+#pragma once
+#include "interpreter/LoopProgram.h"
+#include <vector>
+
+// Runs one cycle of `program` whose first tick is `cycleTick`, appending
+// the events it produces to `out`. Uses computed goto where the compiler
+// supports it and a switch loop elsewhere.
+void runLoopCycle(const LoopProgram& program, std::int64_t cycleTick, std::vector<LoopEvent>& out);
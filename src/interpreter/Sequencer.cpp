@@ -0,0 +1,79 @@
+#include "Sequencer.h"
+#include "interpreter/LoopVM.h"
+#include <iostream>
+
+void Sequencer::addTrack(LoopProgram program, const TempoMap& tempo) {
+	Track track;
+	track.program = std::move(program);
+	track.tempo = tempo;
+	track.events.reserve(track.program.playCount);
+	tracks.push_back(std::move(track));
+}
+
+void Sequencer::beginCycle(Track& track) {
+	++track.cycle;
+	track.events.clear();
+	track.next = 0;
+	runLoopCycle(track.program, track.cycleTick, track.events);
+}
+
+// The frame of the track's next event, or of its cycle end once the
+// current cycle has been released.
+ma_uint64 Sequencer::nextFrame(const Track& track) const {
+	const std::int64_t tick = track.next < track.events.size()
+		? track.events[track.next].tick
+		: track.cycleTick + track.program.lengthTicks;
+	return scheduler.frameAtBeat(track.program.beatAtTick(tick), track.tempo);
+}
+
+void Sequencer::run() {
+	if (tracks.empty()) return;
+
+	scheduler.start();
+	queue = {};
+	cyclesPlayed = 0;
+	for (std::size_t i = 0; i < tracks.size(); ++i) {
+		Track& track = tracks[i];
+		track.tempo.prepare(scheduler.sampleRateHz());
+		track.cycleTick = 0;
+		track.cycle = 0;
+		beginCycle(track);
+		queue.push({ nextFrame(track), i });
+	}
+
+	while (!queue.empty()) {
+		const Wake wake = queue.top();
+		queue.pop();
+		Track& track = tracks[wake.track];
+
+		// Released only once the frame falls inside the lookahead window.
+		if (!scheduler.waitUntilFrame(wake.frame)) break;
+
+		if (track.next < track.events.size()) {
+			const LoopEvent& event = track.events[track.next++];
+			if (!scheduler.schedule(imports.sample(event.sample), wake.frame, event.gain, event.pitch)) break;
+		} else {
+			++cyclesPlayed;
+			if (verbose) {
+				std::cout << "[LOOP] Track " << wake.track + 1 << ": cycle " << track.cycle << " done (drift "
+					<< scheduler.driftFrames() << " frames)\n";
+			}
+			// The next cycle's end has to be a valid tick as well; a track
+			// on a very fine grid can run out of them eventually.
+			const std::int64_t length = track.program.lengthTicks;
+			if (INT64_MAX - track.cycleTick - length < length) {
+				std::cerr << "[LoopError] Track " << wake.track + 1 << " has run out of beat positions.\n";
+				continue;
+			}
+			track.cycleTick += length;
+			beginCycle(track);
+		}
+
+		queue.push({ nextFrame(track), wake.track });
+	}
+
+	const OnsetStats onsets = scheduler.onsetStats();
+	std::cout << "[LOOP] Played " << cyclesPlayed << " cycle(s) on " << tracks.size() << " track(s) (drift "
+		<< scheduler.driftFrames() << " frames, max " << scheduler.maxDriftFrames() << "; onset p99 "
+		<< onsets.p99 << " frames, " << onsets.late << " late)\n";
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "interpreter/LoopProgram.h"
+#include "runtime/ImportManager.h"
+#include "runtime/Scheduler.h"
+#include "runtime/TempoMap.h"
+#include <cstddef>
+#include <queue>
+#include <vector>
+
+// Plays any number of compiled loops side by side as tracks on one
+// scheduler, from the control thread. A min-heap keyed by each track's next
+// wake-up frame picks what to release next, so adding a track costs
+// O(log n) per event and no extra thread.
+class Sequencer {
+public:
+	Sequencer(Scheduler& scheduler, const ImportManager& imports)
+		: scheduler(scheduler), imports(imports) {}
+
+	// Tracks keep the tempo map that was current when they were added.
+	void addTrack(LoopProgram program, const TempoMap& tempo);
+	std::size_t trackCount() const { return tracks.size(); }
+
+	// Prints a line per finished cycle. Off by default: with hundreds of
+	// tracks that is a lot of console output on the thread that has to
+	// meet the lookahead deadlines; run() prints one summary either way.
+	void setVerbose(bool on) { verbose = on; }
+
+	// Starts every track on beat 0 of a shared origin. Returns once an
+	// offline render is complete, a stop is requested, or no track has any
+	// beat positions left.
+	void run();
+
+private:
+	struct Track {
+		LoopProgram program;
+		TempoMap tempo;
+		std::int64_t cycleTick = 0;
+		unsigned long long cycle = 0;
+		// Events of the current cycle, produced by the VM, and the next one
+		// to release; once all are out the track waits for its cycle end.
+		std::vector<LoopEvent> events;
+		std::size_t next = 0;
+	};
+
+	struct Wake {
+		ma_uint64 frame;
+		std::size_t track;
+
+		bool operator>(const Wake& other) const {
+			return frame != other.frame ? frame > other.frame : track > other.track;
+		}
+	};
+
+	Scheduler& scheduler;
+	const ImportManager& imports;
+	std::vector<Track> tracks;
+	bool verbose = false;
+	unsigned long long cyclesPlayed = 0;
+	std::priority_queue<Wake, std::vector<Wake>, std::greater<Wake>> queue;
+
+	void beginCycle(Track& track);
+	ma_uint64 nextFrame(const Track& track) const;
+};
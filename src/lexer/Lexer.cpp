@@ -1,46 +1,177 @@
 #include "Lexer.h"
-#include <cctype>
+#include <array>
+#include <cstdint>
 #include <iostream>
-#include <unordered_map>
-
-static const std::unordered_map<char, TokenType> single_char_tokens = {
-    {'{',                                       TokenType::LEFT_BRACE},
-    {'}',                                       TokenType::RIGHT_BRACE},
-    {',',                                       TokenType::COMMA},
-    {'.',                                       TokenType::DOT},
-    {'/',                                       TokenType::SLASH},
-	{';',                                       TokenType::SEMICOLON}
+#include <utility>
+
+// --- Character classes ------------------------------------------------
+//
+// One table lookup tells scanToken() what a character can start and
+// identifier() whether it can continue a name, independent of the locale.
+
+enum CharFlags : std::uint8_t {
+	CHAR_SPACE      = 1 << 0,
+	CHAR_NEWLINE    = 1 << 1,
+	CHAR_DIGIT      = 1 << 2,
+	CHAR_ALPHA      = 1 << 3,
+	CHAR_IDENT_TAIL = 1 << 4,
+	CHAR_PUNCT      = 1 << 5,
+	CHAR_SLASH      = 1 << 6,
+	CHAR_QUOTE      = 1 << 7,
 };
 
-static const std::unordered_map<std::string, TokenType> double_char_tokens = {
-    {"//",                                      TokenType::COMMENT}
+struct CharTables {
+	std::array<std::uint8_t, 256> flags{};
+	std::array<TokenType, 256> punct{};
 };
 
-static const std::unordered_map<std::string, TokenType> keywords = {
-    {"play",                                   TokenType::PLAY},
-	{"imp",                                    TokenType::IMP},
-	{"as",                                     TokenType::AS},
+static constexpr CharTables makeCharTables() {
+	CharTables t{};
+	t.flags[' '] = t.flags['\r'] = t.flags['\t'] = CHAR_SPACE;
+	t.flags['\n'] = CHAR_NEWLINE;
+	for (int c = '0'; c <= '9'; ++c) t.flags[c] = CHAR_DIGIT | CHAR_IDENT_TAIL;
+	for (int c = 'a'; c <= 'z'; ++c) t.flags[c] = CHAR_ALPHA | CHAR_IDENT_TAIL;
+	for (int c = 'A'; c <= 'Z'; ++c) t.flags[c] = CHAR_ALPHA | CHAR_IDENT_TAIL;
+	t.flags['_'] = CHAR_IDENT_TAIL;
+	t.flags['"'] = CHAR_QUOTE;
+	t.flags['/'] = CHAR_SLASH;
+
+	const std::pair<char, TokenType> punct[] = {
+		{'{', TokenType::LEFT_BRACE},
+		{'}', TokenType::RIGHT_BRACE},
+		{',', TokenType::COMMA},
+		{'.', TokenType::DOT},
+		{';', TokenType::SEMICOLON},
+	};
+	for (const auto& [c, type] : punct) {
+		t.flags[static_cast<unsigned char>(c)] = CHAR_PUNCT;
+		t.punct[static_cast<unsigned char>(c)] = type;
+	}
+	return t;
+}
+
+static constexpr CharTables charTables = makeCharTables();
 
-	{"cpm",									   TokenType::CPM},
-	{"pattern",                                TokenType::PATTERN},
-	{"set",                                    TokenType::SET},
-	{"sample",                                 TokenType::SAMPLE},
-	{"volume",                                 TokenType::VOLUME},
-	{"pitch",                                  TokenType::PITCH},
+static inline std::uint8_t charFlags(char c) {
+	return charTables.flags[static_cast<unsigned char>(c)];
+}
+
+// --- Keywords ---------------------------------------------------------
+//
+// A perfect hash over (length, first char, last char) whose multiplier is
+// searched for at compile time; a static_assert fires if a new keyword
+// makes the search fail.
 
-	{"loop",                                   TokenType::LOOP},
+struct Keyword {
+	std::string_view text;
+	TokenType type;
 };
 
-Lexer::Lexer(const std::string& source)
-	: source(source) { }
+static constexpr Keyword keywordList[] = {
+	{"play",    TokenType::PLAY},
+	{"imp",     TokenType::IMP},
+	{"as",      TokenType::AS},
 
-std::vector<Token> Lexer::scanTokens() {
+	{"cpm",     TokenType::CPM},
+	{"pattern", TokenType::PATTERN},
+	{"set",     TokenType::SET},
+	{"sample",  TokenType::SAMPLE},
+	{"volume",  TokenType::VOLUME},
+	{"pitch",   TokenType::PITCH},
+
+	{"loop",    TokenType::LOOP},
+};
+
+static constexpr std::size_t keywordCount = sizeof(keywordList) / sizeof(keywordList[0]);
+static constexpr std::uint32_t keywordSlots = 32;
+
+static constexpr std::size_t keywordMinLength() {
+	std::size_t n = keywordList[0].text.size();
+	for (const Keyword& k : keywordList) n = k.text.size() < n ? k.text.size() : n;
+	return n;
+}
+
+static constexpr std::size_t keywordMaxLength() {
+	std::size_t n = 0;
+	for (const Keyword& k : keywordList) n = k.text.size() > n ? k.text.size() : n;
+	return n;
+}
+
+static constexpr std::uint32_t keywordSlotBits = 5;
+static_assert((1u << keywordSlotBits) == keywordSlots);
+
+// Multiplicative hash of the packed (first, last, length) key; the top bits
+// of the product pick the slot.
+static constexpr std::uint32_t keywordHash(std::string_view text, std::uint32_t seed) {
+	const std::uint32_t key = static_cast<unsigned char>(text.front())
+		| static_cast<std::uint32_t>(static_cast<unsigned char>(text.back())) << 8
+		| static_cast<std::uint32_t>(text.size()) << 16;
+	return (key * seed) >> (32 - keywordSlotBits);
+}
+
+static constexpr std::uint32_t findKeywordSeed() {
+	for (std::uint32_t seed = 0x9E3779B1u; seed < 0x9E3779B1u + 2 * 65536; seed += 2) {
+		bool used[keywordSlots] = {};
+		bool collision = false;
+		for (const Keyword& k : keywordList) {
+			const std::uint32_t slot = keywordHash(k.text, seed);
+			if (used[slot]) {
+				collision = true;
+				break;
+			}
+			used[slot] = true;
+		}
+		if (!collision) return seed;
+	}
+	return 0;
+}
+
+static constexpr std::uint32_t keywordSeed = findKeywordSeed();
+static_assert(keywordSeed != 0, "no perfect hash seed for the keyword set; grow keywordSlots");
+
+static constexpr std::array<std::int8_t, keywordSlots> makeKeywordSlots() {
+	std::array<std::int8_t, keywordSlots> slots{};
+	for (auto& s : slots) s = -1;
+	for (std::size_t i = 0; i < keywordCount; ++i) {
+		slots[keywordHash(keywordList[i].text, keywordSeed)] = static_cast<std::int8_t>(i);
+	}
+	return slots;
+}
+
+static constexpr auto keywordTable = makeKeywordSlots();
+
+static TokenType classifyWord(std::string_view text) {
+	if (text.size() < keywordMinLength() || text.size() > keywordMaxLength()) return TokenType::IDENTIFIER;
+
+	const std::int8_t index = keywordTable[keywordHash(text, keywordSeed)];
+	if (index >= 0 && keywordList[index].text == text) return keywordList[index].type;
+	return TokenType::IDENTIFIER;
+}
+
+Lexer::Lexer(std::string source)
+	: source(std::move(source)) { }
+
+Token Lexer::nextToken() {
 	while (!isAtEnd()) {
 		start = current;
+		hasToken = false;
 		scanToken();
+		if (hasToken) return token;
 	}
 
-	tokens.emplace_back(TokenType::END_OF_FILE, "EOF", line);
+	start = current;
+	addToken(TokenType::END_OF_FILE);
+	return token;
+}
+
+std::vector<Token> Lexer::scanTokens() {
+	std::vector<Token> tokens;
+	// Roughly one token per four characters in typical programs.
+	tokens.reserve((source.size() - current) / 4 + 1);
+
+	do {
+		tokens.push_back(nextToken());
+	} while (tokens.back().type != TokenType::END_OF_FILE);
 	return tokens;
 }
 
@@ -67,69 +198,60 @@ bool Lexer::match(char expected) {
 }
 
 void Lexer::addToken(TokenType type) {
-	std::string text = source.substr(start, current - start);
-	tokens.emplace_back(type, text, line);
+	emitToken(type, start, current - start);
+}
+
+void Lexer::emitToken(TokenType type, size_t offset, size_t length) {
+	token = {
+		type,
+		static_cast<std::uint32_t>(offset),
+		static_cast<std::uint32_t>(length),
+		static_cast<std::uint32_t>(line)
+	};
+	hasToken = true;
 }
 
 void Lexer::scanToken() {
-    char c = advance();
-
-    std::string two_chars;
-    two_chars += c;
-    two_chars += peek();
-
-    auto dbl = double_char_tokens.find(two_chars);
-    if (dbl != double_char_tokens.end()) {
-        if (dbl->second == TokenType::COMMENT) {
-            advance();
-
-            while (peek() != '\n' && !isAtEnd()) advance();
-
-            return;
-        } else {
-            advance();
-            addToken(dbl->second);
-            return;
-        }
-    }
-
-    auto it = single_char_tokens.find(c);
-    if (it != single_char_tokens.end()) {
-        addToken(it->second);
-        return;
-    }
-
-    switch (c) {
-        case '\n': line++; break;
-        case ' ':
-        case '\r':
-        case '\t':
-            break;
-		case '"': string(); break;
-        default:
-			if (std::isdigit(c)) {
-				current--;
-				number();
-				break;
-			} else if (std::isalpha(c)) {
-                identifier();
-				break;
-            } else {
-                std::cerr << "[Lexer] Unexpected character: '" << c
-                          << "' at line " << line << "\n";
-            }
-            break;
-    }
+	char c = advance();
+
+	switch (charFlags(c)) {
+		case CHAR_SPACE:
+			break;
+		case CHAR_NEWLINE:
+			line++;
+			break;
+		case CHAR_PUNCT:
+			addToken(charTables.punct[static_cast<unsigned char>(c)]);
+			break;
+		case CHAR_SLASH:
+			if (match('/')) {
+				while (peek() != '\n' && !isAtEnd()) advance();
+			} else {
+				addToken(TokenType::SLASH);
+			}
+			break;
+		case CHAR_QUOTE:
+			string();
+			break;
+		case CHAR_DIGIT | CHAR_IDENT_TAIL:
+			current--;
+			number();
+			break;
+		case CHAR_ALPHA | CHAR_IDENT_TAIL:
+			identifier();
+			break;
+		default:
+			std::cerr << "[Lexer] Unexpected character: '" << c
+				<< "' at line " << line << "\n";
+			break;
+	}
 }
 
 
 void Lexer::identifier() {
-	while (std::isalnum(peek()) || peek() == '_') advance();
+	while (charFlags(peek()) & CHAR_IDENT_TAIL) advance();
 
-	std::string text = source.substr(start, current - start);
-	auto it = keywords.find(text);
-	TokenType type = (it != keywords.end()) ? it->second : TokenType::IDENTIFIER;
-	addToken(type);
+	addToken(classifyWord(std::string_view(source.data() + start, current - start)));
 }
 
 void Lexer::string() {
@@ -145,19 +267,18 @@ void Lexer::string() {
 
 	advance();
 
-	std::string value = source.substr(start + 1, current - start - 2);
-	tokens.emplace_back(TokenType::STRING, value, line);
+	// The lexeme excludes the surrounding quotes.
+	emitToken(TokenType::STRING, start + 1, current - start - 2);
 }
 
 void Lexer::number() {
-	while(std::isdigit(peek())) advance();
+	while (charFlags(peek()) & CHAR_DIGIT) advance();
 
-	if (peek() == '.' && std::isdigit(peek_next())) {
-        advance();
-        while(std::isdigit(peek())) {
-            advance();
-        }
+	if (peek() == '.' && (charFlags(peek_next()) & CHAR_DIGIT)) {
+		advance();
+		while (charFlags(peek()) & CHAR_DIGIT) {
+			advance();
+		}
 	}
-	std::string value = source.substr(start, current - start);
-	tokens.emplace_back(TokenType::NUMBER, value, line);
-}
\ No newline at end of file
+	addToken(TokenType::NUMBER);
+}
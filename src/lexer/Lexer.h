@@ -2,17 +2,29 @@
 #include "Token.h"
 #include "TokenType.h"
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Lexer {
 public:
-	Lexer(const std::string& source);
+	// Takes ownership of the source; tokens point into it, so it must not
+	// change while they are in use.
+	Lexer(std::string source);
 
+	// Scans on demand; returns END_OF_FILE forever once the source is
+	// exhausted.
+	Token nextToken();
+
+	// Scans everything that is left in one go.
 	std::vector<Token> scanTokens();
 
+	std::string_view text() const { return source; }
+	std::string_view lexeme(const Token& token) const { return token.lexeme(source); }
+
  private:
 	std::string source;
-	std::vector<Token> tokens;
+	Token token{};
+	bool hasToken = false;
 	size_t start = 0;
 	size_t current = 0;
 	int line = 1;
@@ -25,6 +37,7 @@ public:
 
 	void scanToken();
 	void addToken(TokenType type);
+	void emitToken(TokenType type, size_t offset, size_t length);
 	void identifier();
 	void string();
 	void number();
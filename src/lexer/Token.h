@@ -1,12 +1,19 @@
 #pragma once
-#include <string>
+#include <cstdint>
+#include <string_view>
 #include "TokenType.h"
 
+// A token is a view into the Lexer's source buffer: it stores where its
+// lexeme starts and how long it is, never the text itself.
 struct Token {
 	TokenType type;
-	std::string lexeme;
-	int line;
+	std::uint32_t offset;
+	std::uint32_t length;
+	std::uint32_t line;
 
-	Token(TokenType type, std::string lexeme, int line)
-		: type(type), lexeme(std::move(lexeme)), line(line) { }
-};
\ No newline at end of file
+	std::string_view lexeme(std::string_view source) const {
+		return source.substr(offset, length);
+	}
+};
+
+static_assert(sizeof(Token) == 16, "Token is meant to stay a 16-byte POD");
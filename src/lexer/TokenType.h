@@ -1,6 +1,7 @@
 #pragma once
+#include <cstdint>
 
-enum class TokenType {
+enum class TokenType : std::uint8_t {
 	LEFT_BRACE, RIGHT_BRACE,
 	COMMA, DOT, SLASH, COMMENT,
 	SEMICOLON,
@@ -21,4 +22,4 @@ enum class TokenType {
 	NUMBER,
 
 	END_OF_FILE
-};
\ No newline at end of file
+};
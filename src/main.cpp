@@ -5,39 +5,163 @@
 #include "ast/AstPrinter.h"
 #include <fstream>
 #include <sstream>
+#include <csignal>
+#include <cstdlib>
 #include "audio/engine.h"
+#include "audio/SampleBankFile.h"
+#include "bench/Benchmarks.h"
 
 using namespace std;
 
-int main() {
-	std::ifstream file("examples/example.wv");
+enum class Mode {
+	Run,
+	Render,
+	BenchMix,
+	BenchLexer,
+	BenchLoop,
+	BuildBank,
+};
+
+struct Options {
+	Mode mode = Mode::Run;
+	AudioConfig audio;
+	std::string programPath = "examples/example.wv";
+	std::string renderPath;
+	std::string bankPath;
+	double renderSeconds = 10.0;
+	double masterGain = 1.0;
+	double lookaheadMs = Scheduler::defaultLookaheadMs;
+	bool verbose = false;
+};
+
+static bool parseArgs(int argc, char** argv, Options& options) {
+	AudioConfig& audio = options.audio;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--bench-mix") {
+			options.mode = Mode::BenchMix;
+		} else if (arg == "--bench-lexer") {
+			options.mode = Mode::BenchLexer;
+		} else if (arg == "--bench-loop") {
+			options.mode = Mode::BenchLoop;
+		} else if (arg == "--build-bank" && i + 1 < argc) {
+			options.mode = Mode::BuildBank;
+			options.bankPath = argv[++i];
+		} else if (arg == "--bank" && i + 1 < argc) {
+			options.bankPath = argv[++i];
+		} else if (arg == "--render" && i + 1 < argc) {
+			options.mode = Mode::Render;
+			options.renderPath = argv[++i];
+		} else if (arg == "--seconds" && i + 1 < argc) {
+			options.renderSeconds = std::atof(argv[++i]);
+			if (options.renderSeconds <= 0.0) {
+				std::cerr << "Invalid render length: " << argv[i] << "\n";
+				return false;
+			}
+		} else if (arg == "--gain" && i + 1 < argc) {
+			options.masterGain = std::atof(argv[++i]);
+			if (options.masterGain < 0.0) {
+				std::cerr << "Invalid gain: " << argv[i] << "\n";
+				return false;
+			}
+		} else if (arg == "--verbose") {
+			options.verbose = true;
+		} else if (arg == "--lookahead-ms" && i + 1 < argc) {
+			options.lookaheadMs = std::atof(argv[++i]);
+			if (options.lookaheadMs < Scheduler::minLookaheadMs || options.lookaheadMs > Scheduler::maxLookaheadMs) {
+				std::cerr << "Invalid lookahead: " << argv[i] << " (" << Scheduler::minLookaheadMs
+					<< " to " << Scheduler::maxLookaheadMs << " ms)\n";
+				return false;
+			}
+		} else if (arg == "--voices" && i + 1 < argc) {
+			int voices = std::atoi(argv[++i]);
+			if (voices <= 0) {
+				std::cerr << "Invalid voice count: " << argv[i] << "\n";
+				return false;
+			}
+			audio.voices.maxVoices = static_cast<ma_uint32>(voices);
+		} else if (arg == "--interp" && i + 1 < argc) {
+			if (!parseInterpolation(argv[++i], audio.interpolation)) {
+				std::cerr << "Unknown interpolation: " << argv[i] << " (linear, cubic, sinc)\n";
+				return false;
+			}
+		} else if (arg == "--steal" && i + 1 < argc) {
+			if (!parseStealPolicy(argv[++i], audio.voices.stealPolicy)) {
+				std::cerr << "Unknown steal policy: " << argv[i] << " (oldest, quietest, same-sample)\n";
+				return false;
+			}
+		} else if (!arg.empty() && arg[0] != '-') {
+			options.programPath = arg;
+		} else {
+			std::cerr << "Usage: WavesLang [--voices N] [--gain G] [--steal oldest|quietest|same-sample]\n"
+				<< "                 [--lookahead-ms MS] [--verbose]\n"
+				<< "                 [--interp linear|cubic|sinc]\n"
+				<< "                 [--render out.wav [--seconds S]] [--bank kit.wvbank]\n"
+				<< "                 [--build-bank out.wvbank]\n"
+				<< "                 [--bench-mix] [--bench-lexer] [--bench-loop]\n"
+				<< "                 [program.wv]  (default: examples/example.wv)\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+// First Ctrl-C ends playback at the next scheduler wake-up so the engine
+// can shut down and report; a second one kills the process as usual.
+static void onInterrupt(int) {
+	Scheduler::requestStop();
+	std::signal(SIGINT, SIG_DFL);
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parseArgs(argc, argv, options)) return 1;
+
+	if (options.mode == Mode::BenchMix) return runMixBenchmark();
+	if (options.mode == Mode::BenchLexer) return runLexerBenchmark();
+	if (options.mode == Mode::BenchLoop) return runLoopBenchmark();
+	if (options.mode == Mode::BuildBank) {
+		return buildSampleBankFile(options.bankPath, "src/vendor", options.audio.sampleRate) ? 0 : 1;
+	}
+
+	std::ifstream file(options.programPath);
 	if (!file) {
-		std::cerr << "Error opening file";
+		std::cerr << "Error opening file: " << options.programPath << "\n";
 		return 1;
 	}
 	std::stringstream buffer;
 	buffer << file.rdbuf();
 	std::string source = buffer.str();
 
-	Lexer lexer(source);
-	auto tokens = lexer.scanTokens();
-
-	Parser parser(tokens);
-	auto statements = parser.parse();
+	Lexer lexer(std::move(source));
+	Parser parser(lexer);
+	Program program = parser.parse();
 
 	std::cout << "PARSER : \n" << std::endl;
 	AstPrinter printer;
-	for (auto& st : statements) {
-		if (st) st->accept(printer);
+	for (const Stmt& st : program.statements()) {
+		visitStmt(printer, st);
 	}
 
 	std::cout << "\nINTERPRETER : \n" << std::endl;
 
-	initAudio();
-
+	// Start decoding imports before the audio device, which can take a
+	// while to open; the device always runs at the configured rate.
 	Interpreter interpreter;
-	interpreter.interpret(statements);
+	interpreter.setLookaheadMs(options.lookaheadMs);
+	interpreter.setVerbose(options.verbose);
+	if (!options.bankPath.empty() && !interpreter.attachBank(options.bankPath, options.audio.sampleRate)) return 1;
+	interpreter.prefetch(program, options.audio.sampleRate);
+
+	if (options.mode == Mode::Render) {
+		if (!initOfflineAudio(options.audio, options.renderPath, options.renderSeconds)) return 1;
+	} else {
+		initAudio(options.audio);
+		std::signal(SIGINT, onInterrupt);
+	}
+	setMasterGain(static_cast<float>(options.masterGain));
+
+	interpreter.interpret(program);
 
-	shutdownAudio();
-	return 0;
+	return shutdownAudio() ? 0 : 1;
 }
\ No newline at end of file
@@ -8,39 +8,41 @@ static const std::unordered_set<TokenType> parameterKeywords = {
 	TokenType::PITCH
 };
 
-Parser::Parser(const std::vector<Token>& tokens)
-	: tokens(tokens) { }
+Parser::Parser(Lexer& lexer)
+	: lexer(lexer), source(lexer.text()), current(lexer.nextToken()), last(current) { }
 
-std::vector<std::unique_ptr<Stmt>> Parser::parse() {
-    std::vector<std::unique_ptr<Stmt>> statements;
+Program Parser::parse() {
+    std::vector<Stmt> statements;
 
     while (!isAtEnd()) {
         if (match(TokenType::SEMICOLON)) continue;
-        statements.push_back(declaration());
+        if (auto stmt = declaration()) statements.push_back(*stmt);
     }
 
-    return statements;
+    std::span<const Stmt> stored = arena.copy(statements);
+    return Program(std::move(arena), std::move(symbols), stored);
 }
 
-std::unique_ptr<Stmt> Parser::declaration() {
+std::optional<Stmt> Parser::declaration() {
 	if (match(TokenType::IMP)) return importStatement();
 	if (match(TokenType::PLAY)) return playStatement();
 	if (match(TokenType::SET)) return setStatement();
 	if (match(TokenType::CPM)) return cpmStatement();
 	if (match(TokenType::LOOP)) return loopStatement();
 
-	std::cerr << "[Parser] Unexpected token '" << peek().lexeme << "'\n";
+	std::cerr << "[Parser] Unexpected token '" << peek().lexeme(source) << "'\n";
 	advance();
-	return nullptr;
+	return std::nullopt;
 }
 
-std::unique_ptr<Stmt> Parser::importStatement() {
+std::optional<Stmt> Parser::importStatement() {
 	if (!match(TokenType::LEFT_BRACE)) {
 		std::cerr << "[Parser] Expected '{' after 'imp'.\n";
-		return nullptr;
+		return std::nullopt;
 	}
 
-	std::vector<ImportEntry> entries;
+	std::vector<ImportName>& entries = importScratch;
+	entries.clear();
 
 	while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
 		Token name = advance();
@@ -60,7 +62,8 @@ std::unique_ptr<Stmt> Parser::importStatement() {
 			break;
 		}
 
-		entries.push_back({ name.lexeme, alias.lexeme });
+		const Symbol symbol = intern(alias);
+		entries.push_back({ text(name), symbols.name(symbol), symbol });
 
 		if (match(TokenType::COMMA)) continue;
 		else break;
@@ -70,33 +73,35 @@ std::unique_ptr<Stmt> Parser::importStatement() {
 		std::cerr << "[Parser] Expected '}' after import list.\n";
 	}
 
-	return std::make_unique<ImportStmt>(std::move(entries));
+	return ImportStmt{ arena.copy(entries) };
 }
 
-std::unique_ptr<Stmt> Parser::playStatement() {
+std::optional<Stmt> Parser::playStatement() {
 	Token alias = advance();
 	if (alias.type != TokenType::IDENTIFIER) {
 		std::cerr << "[Parser] Expected alias after 'play'.\n";
-		return nullptr;
+		return std::nullopt;
 	}
 
-	return std::make_unique<PlayStmt>(alias.lexeme);
+	const Symbol symbol = intern(alias);
+	return PlayStmt{ symbols.name(symbol), symbol };
 }
 
-std::unique_ptr<Stmt> Parser::setStatement() {
+std::optional<Stmt> Parser::setStatement() {
 	Token alias = advance();
 
 	if (alias.type != TokenType::IDENTIFIER) {
 		std::cerr << "[Parser] Expected alias after 'set'.\n";
-		return nullptr;
+		return std::nullopt;
 	}
 
 	if (!match(TokenType::LEFT_BRACE)) {
 		std::cerr << "[Parser] Expected '{' after alias in 'set'.\n";
-		return nullptr;
+		return std::nullopt;
 	}
 
-	std::vector<ParamEntry> params;
+	std::vector<ParamEntry>& params = paramScratch;
+	params.clear();
 
 	while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
 		Token name = advance();
@@ -107,17 +112,14 @@ std::unique_ptr<Stmt> Parser::setStatement() {
 		}
 
 		if (isAtEnd()) break;
-		Token value = advance();
-
-		if (value.type != TokenType::STRING &&
-			value.type != TokenType::NUMBER &&
-			value.type != TokenType::IDENTIFIER) {
-			std::cerr << "[Parser] Expected value after '" << name.lexeme << "'.\n";
+		const ParamOp op = lookupParamOp(name.lexeme(source));
+		ParamValue value;
+		if (!paramValue(name, op, value)) {
 			synchronize();
 			continue;
 		}
 
-		params.push_back({ name.lexeme, value.lexeme });
+		params.push_back({ text(name), op, value });
 
 		if (match(TokenType::SEMICOLON)) {
 			continue;
@@ -130,40 +132,81 @@ std::unique_ptr<Stmt> Parser::setStatement() {
 
 	if (!match(TokenType::RIGHT_BRACE)) {
 		std::cerr << "[Parser] Expected '}' after set block.\n";
-		return nullptr;
+		return std::nullopt;
 	}
 
-	return std::make_unique<SetStmt>(alias.lexeme, std::move(params));
+	const Symbol symbol = intern(alias);
+	return SetStmt{ symbols.name(symbol), symbol, arena.copy(params) };
 }
 
 
-std::unique_ptr<Stmt> Parser::cpmStatement() {
+// cpm N;                          constant tempo from the start
+// cpm N at B;                     jump to N at beat B
+// cpm N at B ramp R [linear|exp]; reach N over R beats starting at B
+// `at`, `ramp`, `linear` and `exp` are only words in this position, and
+// the trailing ';' is optional like after any other statement.
+std::optional<Stmt> Parser::cpmStatement() {
 	Token number = advance();
 
 	if (number.type != TokenType::IDENTIFIER && number.type != TokenType::NUMBER) {
 		std::cerr << "[Parser] Expected numeric value after 'cpm'.\n";
-		return nullptr;
+		return std::nullopt;
 	}
 
-	int value = 0;
-
-	try {
-		value = std::stoi(number.lexeme);
-	} catch (...) {
-		std::cerr << "[Parser] Invalid CPM value: " << number.lexeme << "\n";
+	// The whole statement is read before any value is checked, so a bad
+	// value never leaves the rest of it to be parsed as a new statement.
+	// numberValue() reports malformed literals itself.
+	ParamValue value;
+	const bool parsed = number.type == TokenType::NUMBER && numberValue(number, value);
+
+	CpmStmt stmt{ value.exact };
+	bool lengthOk = true;
+	if (matchWord("at")) {
+		ParamValue at;
+		if (!check(TokenType::NUMBER)) {
+			std::cerr << "[Parser] Expected beat position after 'at'.\n";
+			return std::nullopt;
+		}
+		if (!numberValue(advance(), at)) return std::nullopt;
+		stmt.change = true;
+		stmt.atBeat = at.exact;
+
+		if (matchWord("ramp")) {
+			ParamValue length;
+			if (!check(TokenType::NUMBER)) {
+				std::cerr << "[Parser] Expected a positive beat count after 'ramp'.\n";
+				return std::nullopt;
+			}
+			if (!numberValue(advance(), length)) return std::nullopt;
+			lengthOk = length.exact.num > 0;
+			stmt.rampBeats = length.exact;
+			if (matchWord("exp")) stmt.shape = RampShape::Exponential;
+			else matchWord("linear");
+		}
 	}
-
 	match(TokenType::SEMICOLON);
-	return std::make_unique<CpmStmt>(value);
+
+	if (!parsed || value.exact.num <= 0) {
+		if (number.type != TokenType::NUMBER || parsed) {
+			std::cerr << "[Parser] Invalid CPM value: " << (parsed ? value.text : number.lexeme(source)) << "\n";
+		}
+		return std::nullopt;
+	}
+	if (!lengthOk) {
+		std::cerr << "[Parser] Expected a positive beat count after 'ramp'.\n";
+		return std::nullopt;
+	}
+	return stmt;
 }
 
-std::unique_ptr<Stmt> Parser::loopStatement() {
+std::optional<Stmt> Parser::loopStatement() {
 	if (!match(TokenType::LEFT_BRACE)) {
 		std::cerr << "[Parser] Expected '{' in loop.\n";
-		return nullptr;
+		return std::nullopt;
 	}
 
-	std::vector<ParamEntry> params;
+	std::vector<ParamEntry>& params = paramScratch;
+	params.clear();
 
 	while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
 		Token name = advance();
@@ -176,29 +219,98 @@ std::unique_ptr<Stmt> Parser::loopStatement() {
 
 		if (isAtEnd()) break;
 
-		Token value = advance();
-		
-		if (value.type != TokenType::IDENTIFIER &&
-			value.type != TokenType::STRING &&
-			value.type != TokenType::NUMBER) {
-			std::cerr << "[Parser] Expected value after '" << name.lexeme << "'.\n";
+		const ParamOp op = lookupParamOp(name.lexeme(source));
+		ParamValue value;
+		if (!paramValue(name, op, value)) {
 			synchronize();
 			continue;
 		}
 
-		params.push_back({ name.lexeme, value.lexeme });
+		params.push_back({ text(name), op, value });
 		if (!match(TokenType::SEMICOLON)) {
-			std::cerr << "[Parser] Expected ';' after parameter '" << name.lexeme << "'.\n";
+			std::cerr << "[Parser] Expected ';' after parameter '" << name.lexeme(source) << "'.\n";
 			synchronize();
 		}
 	}
 
 	if (!match(TokenType::RIGHT_BRACE)) {
 		std::cerr << "[Parser] Expected '}' after set block.\n";
-		return nullptr;
+		return std::nullopt;
 	}
 
-	return std::make_unique<LoopStmt>(std::move(params));
+	return LoopStmt{ arena.copy(params) };
+}
+
+// Reads a number literal starting at `first`, including an `a/b` fraction.
+bool Parser::numberValue(const Token& first, ParamValue& out) {
+	std::uint32_t end = first.offset + first.length;
+	bool ok = parseRational(first.lexeme(source), out.exact);
+	if (match(TokenType::SLASH)) {
+		Token denominator = advance();
+		Rational d;
+		if (denominator.type != TokenType::NUMBER) {
+			std::cerr << "[Parser] Expected denominator after '/'.\n";
+			return false;
+		}
+		end = denominator.offset + denominator.length;
+		ok = ok && parseRational(denominator.lexeme(source), d) && checkedDivide(out.exact, d, out.exact);
+	}
+	out.text = arena.copy(source.substr(first.offset, end - first.offset));
+	if (!ok) {
+		std::cerr << "[Parser] Invalid number '" << out.text << "'.\n";
+		return false;
+	}
+	out.kind = ValueKind::Number;
+	out.number = out.exact.toDouble();
+	return true;
+}
+
+// Reads the value that follows parameter `name`. Numbers (including
+// `a/b` fractions and quoted numbers such as "1/4") are converted here, so
+// nothing downstream parses text again.
+bool Parser::paramValue(const Token& name, ParamOp op, ParamValue& out) {
+	Token first = advance();
+
+	switch (first.type) {
+	case TokenType::NUMBER:
+		if (!numberValue(first, out)) return false;
+		break;
+	case TokenType::STRING:
+		if (parseRational(first.lexeme(source), out.exact)) {
+			out.kind = ValueKind::Number;
+			out.text = arena.copy(first.lexeme(source));
+			out.number = out.exact.toDouble();
+		} else {
+			out.kind = ValueKind::String;
+			out.symbol = intern(first);
+			out.text = symbols.name(out.symbol);
+		}
+		break;
+	case TokenType::IDENTIFIER:
+		out.kind = ValueKind::Identifier;
+		out.symbol = intern(first);
+		out.text = symbols.name(out.symbol);
+		break;
+	default:
+		std::cerr << "[Parser] Expected value after '" << name.lexeme(source) << "'.\n";
+		return false;
+	}
+
+	const ParamOpInfo& info = paramOpTable[opIndex(op)];
+	if (info.accepts && !info.accepts(out)) {
+		std::cerr << "[Parser] '" << info.name << "' expects " << info.expected
+			<< ", got '" << out.text << "'.\n";
+		return false;
+	}
+	return true;
+}
+
+bool Parser::matchWord(std::string_view word) {
+	if (check(TokenType::IDENTIFIER) && peek().lexeme(source) == word) {
+		advance();
+		return true;
+	}
+	return false;
 }
 
 bool Parser::match(TokenType type) {
@@ -215,7 +327,10 @@ bool Parser::check(TokenType type) const {
 }
 
 Token Parser::advance() {
-	if (!isAtEnd()) current++;
+	if (!isAtEnd()) {
+		last = current;
+		current = lexer.nextToken();
+	}
 	return previous();
 }
 
@@ -223,12 +338,23 @@ bool Parser::isAtEnd() const {
 	return peek().type == TokenType::END_OF_FILE;
 }
 
-Token Parser::peek() const {
-	return tokens[current];
+const Token& Parser::peek() const {
+	return current;
+}
+
+const Token& Parser::previous() const {
+	return last;
+}
+
+Symbol Parser::intern(const Token& token) {
+	const std::string_view name = token.lexeme(source);
+	const Symbol symbol = symbols.find(name);
+	if (symbol != InvalidSymbol) return symbol;
+	return symbols.add(arena.copy(name));
 }
 
-Token Parser::previous() const {
-	return tokens[current - 1];
+std::string_view Parser::text(const Token& token) {
+	return symbols.name(intern(token));
 }
 
 void Parser::synchronize() {
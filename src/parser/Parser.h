@@ -1,31 +1,55 @@
 #pragma once
 #include <vector>
-#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "lexer/Lexer.h"
 #include "lexer/Token.h"
 #include "Stmt.h"
 
 class Parser {
 public:
-	Parser(const std::vector<Token>& tokens);
+	// Pulls tokens from `lexer` one at a time; only the current and the
+	// previous token are ever held.
+	Parser(Lexer& lexer);
 
-	std::vector<std::unique_ptr<Stmt>> parse();
+	// The returned Program owns every string and list it refers to and
+	// does not depend on the lexer afterwards.
+	Program parse();
 
 private:
-	const std::vector<Token> tokens;
-	size_t current = 0;
+	Lexer& lexer;
+	std::string_view source;
+	Token current;
+	Token last;
+	Arena arena;
+	SymbolTable symbols;
+	// Reused between statements; each finished list is copied into the
+	// arena as one contiguous run.
+	std::vector<ImportName> importScratch;
+	std::vector<ParamEntry> paramScratch;
 
-	std::unique_ptr<Stmt> declaration();
-	std::unique_ptr<Stmt> importStatement();
-	std::unique_ptr<Stmt> playStatement();
-	std::unique_ptr<Stmt> setStatement();
-	std::unique_ptr<Stmt> cpmStatement();
-	std::unique_ptr<Stmt> loopStatement();
+	std::optional<Stmt> declaration();
+	std::optional<Stmt> importStatement();
+	std::optional<Stmt> playStatement();
+	std::optional<Stmt> setStatement();
+	std::optional<Stmt> cpmStatement();
+	std::optional<Stmt> loopStatement();
+
+	bool paramValue(const Token& name, ParamOp op, ParamValue& out);
+
+	bool numberValue(const Token& first, ParamValue& out);
 
 	bool match(TokenType type);
+	// Matches an identifier spelled `word`, for contextual keywords.
+	bool matchWord(std::string_view word);
 	bool check(TokenType type) const;
 	Token advance();
 	bool isAtEnd() const;
-	Token peek() const;
-	Token previous() const;
+	const Token& peek() const;
+	const Token& previous() const;
+	Symbol intern(const Token& token);
+	// Interned spelling of `token`, owned by the program being built.
+	std::string_view text(const Token& token);
 	void synchronize();
 };
\ No newline at end of file
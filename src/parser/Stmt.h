@@ -1,59 +1,77 @@
 #pragma once
+#include <span>
+#include <string_view>
+#include <variant>
 #include <vector>
-#include <string>
-#include <memory>
-#include "runtime/ImportManager.h"
+#include "common/Arena.h"
 #include "common/Entries.h"
+#include "common/SymbolTable.h"
+#include "runtime/TempoMap.h"
 
-class StmtVisitor;
+// Statements are plain values: every string and child list points into
+// the arena of the Program that owns them.
 
-class Stmt {
-public:
-	virtual ~Stmt() = default;
-	virtual void accept(StmtVisitor& visitor) = 0;
+struct ImportName {
+	std::string_view name;
+	std::string_view alias;
+	Symbol symbol;
 };
 
-class ImportStmt : public Stmt {
-public:
-	std::vector<ImportEntry> entries;
-	ImportStmt(std::vector<ImportEntry> e) : entries(std::move(e)) {}
-	void accept(StmtVisitor& visitor) override;
+struct ImportStmt {
+	std::span<const ImportName> entries;
 };
 
-class PlayStmt : public Stmt {
-public:
-	std::string alias;
-	PlayStmt(std::string a) : alias(std::move(a)) {}
-	void accept(StmtVisitor& visitor) override;
+struct PlayStmt {
+	std::string_view alias;
+	Symbol symbol;
 };
 
-class SetStmt : public Stmt {
-public:
-	std::string alias;
-	std::vector<ParamEntry> params;
-	SetStmt(std::string a, std::vector<ParamEntry> p) : alias(std::move(a)), params(std::move(p)) {}
-	void accept(StmtVisitor& visitor) override;
+struct SetStmt {
+	std::string_view alias;
+	Symbol symbol;
+	std::span<const ParamEntry> params;
 };
 
-class CpmStmt : public Stmt {
-public:
-	int value;
-	CpmStmt(int v) : value(v) {}
-	void accept(StmtVisitor& visitor) override; 
+struct CpmStmt {
+	Rational value{};
+	// Set for `cpm N at B [ramp R [linear|exp]]`: a tempo change on the
+	// timeline rather than a new constant tempo.
+	bool change = false;
+	Rational atBeat{};
+	Rational rampBeats{};
+	RampShape shape = RampShape::Linear;
 };
 
-class LoopStmt : public Stmt {
-public:
-	std::vector<ParamEntry> params;
-	LoopStmt(std::vector<ParamEntry> p) : params(std::move(p)) {}
-	void accept(StmtVisitor& visitor) override;
+struct LoopStmt {
+	std::span<const ParamEntry> params;
 };
 
-class StmtVisitor {
+using Stmt = std::variant<ImportStmt, PlayStmt, SetStmt, CpmStmt, LoopStmt>;
+
+// Calls visitor.visit(node) with the concrete statement type.
+template <typename Visitor>
+void visitStmt(Visitor& visitor, const Stmt& stmt) {
+	std::visit([&visitor](const auto& node) { visitor.visit(node); }, stmt);
+}
+
+// A parsed program: the statements sit in one contiguous array and all of
+// their strings and child lists come from the same arena, so dropping the
+// Program releases the whole tree at once.
+class Program {
 public:
-	virtual void visitImportStmt(ImportStmt& stmt) = 0;
-	virtual void visitPlayStmt(PlayStmt& stmt) = 0;
-	virtual void visitSetStmt(SetStmt& stmt) = 0;
-	virtual void visitCpmStmt(CpmStmt& stmt) = 0;
-	virtual void visitLoopStmt(LoopStmt& stmt) = 0;
-};
\ No newline at end of file
+	Program() = default;
+	Program(Arena arena, SymbolTable symbols, std::span<const Stmt> statements)
+		: arena(std::move(arena)), symbolTable(std::move(symbols)), stmts(statements) {}
+
+	Program(Program&&) noexcept = default;
+	Program& operator=(Program&&) noexcept = default;
+
+	std::span<const Stmt> statements() const { return stmts; }
+	// Every identifier and string the program mentions, interned once.
+	const SymbolTable& symbols() const { return symbolTable; }
+
+private:
+	Arena arena;
+	SymbolTable symbolTable;
+	std::span<const Stmt> stmts;
+};
@@ -1,22 +1,52 @@
 #pragma once
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <iostream>
 #include <filesystem>
 #include "common/Entries.h"
+#include "audio/SampleBank.h"
 
 class ImportManager {
 public:
-	void addImport(const std::string& alias, const ImportEntry& entry) {
-		imports[alias] = entry;
+	// One slot per program symbol; aliases are bound by symbol id.
+	void reset(std::size_t symbolCount) {
+		imports.assign(symbolCount, ImportEntry{});
 	}
 
-	const ImportEntry* get(const std::string& alias) const {
-		auto it = imports.find(alias);
-		if (it != imports.end()) return &it->second;
-		return nullptr;
+	void addImport(Symbol alias, ImportEntry entry) {
+		imports[alias] = std::move(entry);
+	}
+
+	// Null when `alias` was never bound to a decoded sample.
+	const ImportEntry* get(Symbol alias) const {
+		if (alias >= imports.size() || imports[alias].sample == InvalidSample) return nullptr;
+		return &imports[alias];
+	}
+
+	bool attachBank(const std::string& path, ma_uint32 sampleRate) {
+		return samples.attachBank(path, sampleRate);
+	}
+
+	// InvalidSample unless an attached bank contains `name`.
+	SampleHandle requestMapped(std::string_view name) {
+		return samples.requestMapped(name);
+	}
+
+	// Starts decoding `path` in the background if it is not already known.
+	SampleHandle requestSample(const std::string& path, ma_uint32 sampleRate) {
+		return samples.request(path, sampleRate);
+	}
+
+	// Waits for `handle` to finish decoding; null if it failed.
+	const Sample* awaitSample(SampleHandle handle) {
+		return samples.await(handle);
+	}
+
+	const Sample& sample(SampleHandle handle) const {
+		return samples.get(handle);
 	}
 
 private:
-	std::unordered_map<std::string, ImportEntry> imports;
+	std::vector<ImportEntry> imports;
+	SampleBank samples;
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "Scheduler.h"
+#include "audio/engine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+void Scheduler::start() {
+	sampleRate = static_cast<double>(audioSampleRate());
+	lookaheadFrames = static_cast<ma_uint64>(std::llround(lookaheadMs * sampleRate / 1000.0));
+
+	clockOriginTime = Clock::now();
+	clockOriginFrame = audioInitialized() ? audioTimeInFrames() : 0;
+	originFrame = clockOriginFrame + lookaheadFrames;
+
+	drift.store(0, std::memory_order_relaxed);
+	maxDrift.store(0, std::memory_order_relaxed);
+}
+
+ma_uint64 Scheduler::frameAtBeat(Rational beat, const TempoMap& tempo) const {
+	return originFrame + static_cast<ma_uint64>(std::llround(tempo.framesAtBeat(beat)));
+}
+
+ma_uint64 Scheduler::nowFrame() const {
+	if (audioInitialized()) return audioTimeInFrames();
+
+	// No device: fall back to steady_clock so loops keep their timing.
+	const std::chrono::duration<double> elapsed = Clock::now() - clockOriginTime;
+	return clockOriginFrame + static_cast<ma_uint64>(elapsed.count() * sampleRate);
+}
+
+bool Scheduler::waitUntilFrame(ma_uint64 frame) {
+	const ma_uint64 target = frame - lookaheadFrames;
+	if (stopping.load(std::memory_order_relaxed)) return false;
+	if (audioOffline()) return advanceAudioTo(target);
+
+	// Coarse sleep to the steady_clock estimate of the deadline, in slices
+	// so a stop request is noticed promptly, then follow the engine clock
+	// itself, which only advances once per device period.
+	const std::chrono::duration<double> untilTarget((target - clockOriginFrame) / sampleRate);
+	const Clock::time_point deadline = clockOriginTime + std::chrono::duration_cast<Clock::duration>(untilTarget);
+	while (Clock::now() < deadline) {
+		if (stopping.load(std::memory_order_relaxed)) return false;
+		std::this_thread::sleep_until((std::min)(deadline, Clock::now() + std::chrono::milliseconds(50)));
+	}
+
+	ma_uint64 now = nowFrame();
+	while (now < target) {
+		if (stopping.load(std::memory_order_relaxed)) return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		now = nowFrame();
+	}
+
+	const std::chrono::duration<double> elapsed = Clock::now() - clockOriginTime;
+	const ma_int64 expected = static_cast<ma_int64>(std::llround(elapsed.count() * sampleRate));
+	const ma_int64 measured = static_cast<ma_int64>(now - clockOriginFrame) - expected;
+
+	drift.store(measured, std::memory_order_relaxed);
+	if (std::llabs(measured) > std::llabs(maxDrift.load(std::memory_order_relaxed))) {
+		maxDrift.store(measured, std::memory_order_relaxed);
+	}
+	return true;
+}
+
+OnsetStats Scheduler::onsetStats() const {
+	return audioOnsetStats();
+}
+
+// The engine holds a bounded number of future triggers. With a wide
+// window that can fill up, so wait for earlier voices to start instead of
+// losing this one. Triggers are handed over in frame order, so every one
+// it holds starts no later than `frame`; if that still is not enough the
+// trigger goes out late and shows up in the onset statistics.
+bool Scheduler::schedule(const Sample& sample, ma_uint64 frame, double volume, double pitch) {
+	while (!scheduleSample(sample, frame, static_cast<float>(volume), static_cast<float>(pitch))) {
+		if (stopping.load(std::memory_order_relaxed)) return false;
+		if (audioOffline()) {
+			if (!advanceAudioTo((std::max)(frame, audioTimeInFrames() + 1))) return false;
+		} else {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "libs/miniaudio.h"
+#include "audio/OnsetHistogram.h"
+#include "audio/SampleBank.h"
+#include "runtime/TempoMap.h"
+#include <atomic>
+#include <chrono>
+
+// Turns loop steps into events stamped with an absolute engine frame and
+// hands them to the audio engine, which starts each one on that exact frame.
+//
+// Events are released through a lookahead window: the control thread holds
+// each one until the engine clock is within the window of its frame, so
+// only a bounded slice of the future is ever queued on the audio side. A
+// wider window rides out longer control-thread stalls at the cost of
+// reacting later to changes.
+//
+// Every position is derived from the loop's origin rather than from the
+// previous cycle, so rounding and the loop body's own run time never add up.
+class Scheduler {
+public:
+	static constexpr double defaultLookaheadMs = 50.0;
+	static constexpr double minLookaheadMs = 5.0;
+	static constexpr double maxLookaheadMs = 2000.0;
+
+	// Makes waitUntilFrame() return false from now on, ending playback at
+	// the next wake-up. Async-signal-safe, so a SIGINT handler may call it.
+	static void requestStop() { stopping.store(true, std::memory_order_relaxed); }
+
+	// Takes effect at the next start().
+	void setLookaheadMs(double ms) { lookaheadMs = ms; }
+
+	// Anchors beat 0 one lookahead window ahead of the current engine time.
+	// All tracks share this origin.
+	void start();
+
+	ma_uint32 sampleRateHz() const { return static_cast<ma_uint32>(sampleRate); }
+
+	// Absolute frame of `beat` beats after the origin under `tempo`, which
+	// must have been prepared at this scheduler's sample rate. This is the
+	// only place a beat position is rounded to a frame.
+	ma_uint64 frameAtBeat(Rational beat, const TempoMap& tempo) const;
+
+	// Blocks until `frame` enters the lookahead window, i.e. the engine clock
+	// is one window before it, then samples the drift between the engine
+	// clock and steady_clock. When rendering offline the engine is advanced
+	// to that point instead, and false is returned once the render is
+	// complete or a stop has been requested.
+	bool waitUntilFrame(ma_uint64 frame);
+
+	// Hands one trigger to the engine, waiting for room if it is full.
+	// Returns false if playback ended while waiting.
+	bool schedule(const Sample& sample, ma_uint64 frame, double volume, double pitch);
+
+	// Engine clock minus steady_clock since start(), in frames, as measured
+	// at the last wake-up, and the largest magnitude seen so far.
+	ma_int64 driftFrames() const { return drift.load(std::memory_order_relaxed); }
+	ma_int64 maxDriftFrames() const { return maxDrift.load(std::memory_order_relaxed); }
+
+	// How late the engine actually started the events handed to it.
+	OnsetStats onsetStats() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	double lookaheadMs = defaultLookaheadMs;
+	double sampleRate = 48000.0;
+	ma_uint64 lookaheadFrames = 0;
+	ma_uint64 originFrame = 0;
+
+	Clock::time_point clockOriginTime;
+	ma_uint64 clockOriginFrame = 0;
+
+	std::atomic<ma_int64> drift{ 0 };
+	std::atomic<ma_int64> maxDrift{ 0 };
+
+	static inline std::atomic<bool> stopping{ false };
+	static_assert(std::atomic<bool>::is_always_lock_free, "requestStop() is called from signal handlers");
+
+	ma_uint64 nowFrame() const;
+};
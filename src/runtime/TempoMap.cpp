@@ -0,0 +1,165 @@
+#include "TempoMap.h"
+#include <algorithm>
+#include <cmath>
+
+// With tempo T(x) in beats per minute, x beats into a segment:
+//
+//   constant     frames = x * F / T0
+//   linear       T(x) = T0 + k x,    frames = F / k * ln(1 + k x / T0)
+//   exponential  T(x) = T0 e^(a x),  frames = F / (a T0) * (1 - e^(-a x))
+//
+// where F is frames per minute. Each is inverted in closed form as well.
+
+TempoMap::TempoMap(Rational cpm) {
+	Segment first;
+	first.startCpm = cpm;
+	first.endCpm = cpm;
+	segments.push_back(first);
+}
+
+bool TempoMap::addChange(Rational beat, Rational cpm, Rational rampBeats, RampShape shape) {
+	// Every change ends in an open constant segment, so that is always the
+	// last one; starting before it means starting inside a ramp or going
+	// back in time.
+	const Segment& last = segments.back();
+	if (beat < last.startBeat || cpm.num <= 0 || rampBeats.num < 0) return false;
+
+	const Rational fromCpm = last.endCpm;
+	Rational rampEnd;
+	if (!checkedAdd(beat, rampBeats, rampEnd)) return false;
+	if (beat == last.startBeat) segments.pop_back();
+
+	if (rampBeats.num > 0 && cpm != fromCpm) {
+		Segment ramp;
+		ramp.kind = shape == RampShape::Linear ? Kind::Linear : Kind::Exponential;
+		ramp.startBeat = beat;
+		ramp.startCpm = fromCpm;
+		ramp.endCpm = cpm;
+		ramp.lengthBeats = rampBeats;
+		segments.push_back(ramp);
+		beat = rampEnd;
+	}
+
+	Segment hold;
+	hold.startBeat = beat;
+	hold.startCpm = cpm;
+	hold.endCpm = cpm;
+	segments.push_back(hold);
+	++changes;
+	return true;
+}
+
+void TempoMap::prepare(std::uint32_t sampleRate) {
+	framesPerMinute = static_cast<std::int64_t>(sampleRate) * 60;
+	double frame = 0.0;
+	for (std::size_t i = 0; i < segments.size(); ++i) {
+		Segment& s = segments[i];
+		const double c0 = s.startCpm.toDouble();
+		const double c1 = s.endCpm.toDouble();
+		const double length = s.lengthBeats.toDouble();
+		switch (s.kind) {
+		case Kind::Constant:
+			s.rate = 0.0;
+			break;
+		case Kind::Linear:
+			s.rate = (c1 - c0) / length;
+			break;
+		case Kind::Exponential:
+			s.rate = std::log(c1 / c0) / length;
+			break;
+		}
+		if (i > 0) {
+			const Segment& previous = segments[i - 1];
+			frame += framesInto(previous, s.startBeat);
+		}
+		s.startFrame = frame;
+	}
+}
+
+// beats * F / cpm, computed exactly and rounded once where 128 bits are
+// enough, in long double otherwise.
+double TempoMap::constantFrames(Rational beats, Rational cpm) const {
+#ifdef __SIZEOF_INT128__
+	__int128 num = 0;
+	if (!__builtin_mul_overflow(static_cast<__int128>(beats.num) * framesPerMinute, cpm.den, &num)) {
+		const __int128 den = static_cast<__int128>(beats.den) * cpm.num;
+		const __int128 whole = num / den;
+		return static_cast<double>(whole) + static_cast<double>(num - whole * den) / static_cast<double>(den);
+	}
+#endif
+	return static_cast<double>(static_cast<long double>(beats.num) * framesPerMinute * cpm.den
+		/ (static_cast<long double>(beats.den) * cpm.num));
+}
+
+// Frames from the start of `s` to `beat`. Should the offset not fit in a
+// 64-bit fraction, it is taken in double precision instead.
+double TempoMap::framesInto(const Segment& s, Rational beat) const {
+	Rational offset;
+	const bool exact = checkedSub(beat, s.startBeat, offset);
+	const double x = exact ? offset.toDouble() : beat.toDouble() - s.startBeat.toDouble();
+	const double c0 = s.startCpm.toDouble();
+	const double fpm = static_cast<double>(framesPerMinute);
+	switch (s.kind) {
+	case Kind::Linear:
+		return fpm / s.rate * std::log1p(s.rate * x / c0);
+	case Kind::Exponential:
+		return -fpm / (s.rate * c0) * std::expm1(-s.rate * x);
+	case Kind::Constant:
+	default:
+		return exact ? constantFrames(offset, s.startCpm) : x * fpm / c0;
+	}
+}
+
+double TempoMap::beatsInto(const Segment& s, double frames) const {
+	const double c0 = s.startCpm.toDouble();
+	const double fpm = static_cast<double>(framesPerMinute);
+	switch (s.kind) {
+	case Kind::Linear:
+		return c0 / s.rate * std::expm1(s.rate * frames / fpm);
+	case Kind::Exponential:
+		return -std::log1p(-s.rate * c0 * frames / fpm) / s.rate;
+	case Kind::Constant:
+	default:
+		return frames * c0 / fpm;
+	}
+}
+
+const TempoMap::Segment& TempoMap::segmentAtBeat(Rational beat) const {
+	auto it = std::upper_bound(segments.begin() + 1, segments.end(), beat,
+		[](const Rational& b, const Segment& s) { return b < s.startBeat; });
+	return *(it - 1);
+}
+
+const TempoMap::Segment& TempoMap::segmentAtFrame(double frames) const {
+	auto it = std::upper_bound(segments.begin() + 1, segments.end(), frames,
+		[](double f, const Segment& s) { return f < s.startFrame; });
+	return *(it - 1);
+}
+
+double TempoMap::framesAtBeat(Rational beat) const {
+	const Segment& s = segmentAtBeat(beat);
+	return s.startFrame + framesInto(s, beat);
+}
+
+double TempoMap::beatAtFrames(double frames) const {
+	const Segment& s = segmentAtFrame(frames);
+	return s.startBeat.toDouble() + beatsInto(s, frames - s.startFrame);
+}
+
+double TempoMap::cpmAtBeat(double beat) const {
+	auto it = std::upper_bound(segments.begin() + 1, segments.end(), beat,
+		[](double b, const Segment& s) { return b < s.startBeat.toDouble(); });
+	const Segment& s = *(it - 1);
+	const double c0 = s.startCpm.toDouble();
+	const double c1 = s.endCpm.toDouble();
+	const double x = beat - s.startBeat.toDouble();
+	switch (s.kind) {
+	case Kind::Linear:
+		return c0 + (c1 - c0) * x / s.lengthBeats.toDouble();
+	case Kind::Exponential:
+		return c0 * std::pow(c1 / c0, x / s.lengthBeats.toDouble());
+	case Kind::Constant:
+	default:
+		return c0;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "common/Rational.h"
+#include <cstdint>
+#include <vector>
+
+enum class RampShape : std::uint8_t {
+	Linear,      // tempo changes by the same cpm every beat
+	Exponential  // tempo changes by the same ratio every beat
+};
+
+// Tempo as a function of beat position: a run of constant sections joined
+// by optional ramps. Beat <-> frame conversions integrate the tempo in
+// closed form and find their segment by binary search, so both directions
+// are O(log n) in the number of changes.
+//
+// Beats, tempos and change points are exact fractions. Inside a constant
+// segment a beat converts to frames with integer arithmetic and a single
+// rounding at the end, so a pattern lands on the same frames every cycle
+// no matter how long it runs. Ramps are integrated in double precision.
+class TempoMap {
+public:
+	explicit TempoMap(Rational cpm = { 120, 1 });
+
+	// From `beat` on the tempo moves to `cpm`, reaching it after
+	// `rampBeats` beats (0 jumps straight there). Changes have to be added
+	// in order and may not start inside an earlier ramp; returns false
+	// otherwise, or if the ramp's end does not fit in a 64-bit fraction.
+	bool addChange(Rational beat, Rational cpm, Rational rampBeats, RampShape shape);
+
+	double initialCpm() const { return segments.front().startCpm.toDouble(); }
+	std::size_t changeCount() const { return changes; }
+
+	// Fills in each segment's start frame. Must be called before any
+	// conversion and again whenever the rate changes.
+	void prepare(std::uint32_t sampleRate);
+
+	// Frames from beat 0 to `beat`, not yet rounded.
+	double framesAtBeat(Rational beat) const;
+	// Inverse of framesAtBeat().
+	double beatAtFrames(double frames) const;
+
+	// Tempo in cpm at `beat`.
+	double cpmAtBeat(double beat) const;
+
+private:
+	enum class Kind : std::uint8_t { Constant, Linear, Exponential };
+
+	struct Segment {
+		Kind kind = Kind::Constant;
+		Rational startBeat{};
+		Rational startCpm{ 120, 1 };
+		Rational endCpm{ 120, 1 };
+		Rational lengthBeats{};     // ramps only; constant segments are open-ended
+		double startFrame = 0.0;    // set by prepare()
+		double rate = 0.0;          // ramp slope (linear) or log-rate (exponential)
+	};
+
+	std::vector<Segment> segments;
+	// Accepted addChange() calls; a ramp adds two segments and a change
+	// on the previous change's beat replaces one, so this is kept apart.
+	std::size_t changes = 0;
+	std::int64_t framesPerMinute = 0;
+
+	const Segment& segmentAtBeat(Rational beat) const;
+	const Segment& segmentAtFrame(double frames) const;
+	double constantFrames(Rational beats, Rational cpm) const;
+	double framesInto(const Segment& segment, Rational beat) const;
+	double beatsInto(const Segment& segment, double frames) const;
+};